@@ -0,0 +1,123 @@
+/*
+  ==============================================================================
+
+    AnimationClock.h
+    One display-synchronised tick shared by every open editor in the process.
+    Held through a SharedResourcePointer; the vblank attachment rides on the
+    first subscriber whose editor is showing, and moves on when that editor
+    closes, is hidden or is minimised (which hosts may do without closing
+    it, and which stops its vblank callbacks).
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+class AnimationClock : private juce::ComponentListener,
+                       private juce::Timer
+{
+public:
+    static constexpr double maxRateHz = 30.0;
+
+    struct Listener
+    {
+        virtual ~Listener() {}
+        virtual void animationTick() = 0;
+    };
+
+    AnimationClock() {}
+    ~AnimationClock() override {}
+
+    // Message thread only
+    void subscribe(juce::Component& host, Listener& listener)
+    {
+        subscribers.push_back({ &host, &listener });
+        host.addComponentListener(this);
+
+        // Minimising changes no component's visibility, so that is caught by polling
+        if (! isTimerRunning())
+            startTimerHz(visibilityPollHz);
+
+        attachToShowingSubscriber();
+    }
+
+    void unsubscribe(Listener& listener)
+    {
+        auto it = std::find_if(subscribers.begin(), subscribers.end(),
+                               [&listener](const Subscriber& s) { return s.listener == &listener; });
+        if (it == subscribers.end())
+            return;
+
+        it->host->removeComponentListener(this);
+        if (it->host == driver)
+        {
+            vblank = {};
+            driver = nullptr;
+        }
+
+        subscribers.erase(it);
+
+        if (subscribers.empty())
+            stopTimer();
+        else
+            attachToShowingSubscriber();
+    }
+
+private:
+    struct Subscriber
+    {
+        juce::Component* host;
+        Listener* listener;
+    };
+
+    static constexpr int visibilityPollHz = 2;
+
+    // The first showing subscriber drives; if none is showing, the first one waits for its
+    // editor to come back
+    void attachToShowingSubscriber()
+    {
+        juce::Component* host = nullptr;
+        if (driver != nullptr && driver->isShowing())
+            host = driver;
+
+        for (size_t i = 0; i < subscribers.size() && host == nullptr; ++i)
+            if (subscribers[i].host->isShowing())
+                host = subscribers[i].host;
+
+        if (host == nullptr && ! subscribers.empty())
+            host = subscribers.front().host;
+
+        if (host == driver)
+            return;
+
+        vblank = {};
+        driver = host;
+        if (driver != nullptr)
+            vblank = juce::VBlankAttachment(driver, [this](double timestampSec) { tick(timestampSec); });
+    }
+
+    void componentVisibilityChanged(juce::Component&) override       { attachToShowingSubscriber(); }
+    void componentParentHierarchyChanged(juce::Component&) override { attachToShowingSubscriber(); }
+    void timerCallback() override                                   { attachToShowingSubscriber(); }
+
+    void tick(double timestampSec)
+    {
+        // Displays refresh at 60-144 Hz; the meters don't need more than maxRateHz
+        if (timestampSec - lastTickSec < 1.0 / maxRateHz - 0.002)
+            return;
+
+        lastTickSec = timestampSec;
+
+        for (size_t i = 0; i < subscribers.size(); ++i)
+            subscribers[i].listener->animationTick();
+    }
+
+    std::vector<Subscriber> subscribers;
+    juce::Component* driver = nullptr; // Host the vblank attachment rides on
+    juce::VBlankAttachment vblank;
+    double lastTickSec = 0.0;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (AnimationClock)
+};
@@ -0,0 +1,197 @@
+/*
+  ==============================================================================
+
+    BandSplitter.h
+    Linkwitz-Riley crossover bank splitting a signal into low / low-mid /
+    presence / air bands. The detector and Harmonics each run their own
+    instance: they split different signals (the mono key before the chain,
+    and the stereo audio after Dynamics, EQ and Tame), so only the crossover
+    code, band edges and crossover coefficients are shared, not the split
+    itself.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "DspTableCache.h"
+
+class BandSplitter
+{
+public:
+    enum Band
+    {
+        low = 0,   // Fundamental weight and mud (below the scoop)
+        lowMid,    // Just above the EQ scoop, where Grit lives
+        presence,  // Harsh / piercing region the Timbre detector watches
+        air,       // Clarity harmonics
+        numBands
+    };
+
+    static constexpr float lowCrossover  = 350.0f;
+    static constexpr float midCrossover  = 2500.0f;
+    static constexpr float highCrossover = 6000.0f;
+
+    BandSplitter() {}
+    ~BandSplitter() {}
+
+    // Band storage comes from the owner's ScratchArena; see setScratch().
+    static size_t getScratchSize(int numChannels, int maximumBlockSize)
+    {
+        return (size_t) numBands * (size_t) numChannels * (size_t) maximumBlockSize;
+    }
+
+    void prepare(const juce::dsp::ProcessSpec& spec)
+    {
+        numChannels = (int) spec.numChannels;
+        maxBlockSize = (int) spec.maximumBlockSize;
+
+        // Every splitter at this rate shares one set of coefficients per crossover
+        const auto lowEdge  = tables->getCrossover(spec.sampleRate, lowCrossover);
+        const auto midEdge  = tables->getCrossover(spec.sampleRate, midCrossover);
+        const auto highEdge = tables->getCrossover(spec.sampleRate, highCrossover);
+
+        splitMid.prepare(midEdge, numChannels);
+        splitLow.prepare(lowEdge, numChannels);
+        splitHigh.prepare(highEdge, numChannels);
+
+        // The halves of the first split are phase-matched to the crossover they
+        // never pass through, so the four bands sum back to an allpass response.
+        compensateLowHalf.assign((size_t) numChannels, juce::dsp::IIR::Filter<float> (highEdge.allPass));
+        compensateHighHalf.assign((size_t) numChannels, juce::dsp::IIR::Filter<float> (lowEdge.allPass));
+
+        reset();
+    }
+
+    // Points the bands at getScratchSize() floats of working memory. Call after prepare().
+    void setScratch(float* memory)
+    {
+        for (int b = 0; b < numBands; ++b)
+        {
+            auto& pointers = channelPointers[(size_t) b];
+            pointers.resize((size_t) numChannels);
+            for (int channel = 0; channel < numChannels; ++channel)
+                pointers[(size_t) channel] = memory + ((size_t) (b * numChannels + channel)) * (size_t) maxBlockSize;
+
+            bands[b].setDataToReferTo(pointers.data(), numChannels, maxBlockSize);
+        }
+    }
+
+    void reset()
+    {
+        for (auto* s : { &splitMid, &splitLow, &splitHigh })
+            s->reset();
+
+        for (auto* filters : { &compensateLowHalf, &compensateHighHalf })
+            for (auto& f : *filters)
+                f.reset();
+
+        bandRMS.fill(0.0f);
+    }
+
+    // Splits the first channelsToProcess channels of input into the four bands.
+    void process(const juce::AudioBuffer<float>& input, int channelsToProcess, int numSamples)
+    {
+        channelsToProcess = juce::jmin(channelsToProcess, numChannels, input.getNumChannels());
+        processedChannels = channelsToProcess;
+        processedSamples = numSamples;
+
+        for (int channel = 0; channel < channelsToProcess; ++channel)
+        {
+            auto* in         = input.getReadPointer(channel);
+            auto* lowData    = bands[low].getWritePointer(channel);
+            auto* lowMidData = bands[lowMid].getWritePointer(channel);
+            auto* presData   = bands[presence].getWritePointer(channel);
+            auto* airData    = bands[air].getWritePointer(channel);
+
+            for (int sample = 0; sample < numSamples; ++sample)
+            {
+                float lowHalf, highHalf;
+                splitMid.processSample(channel, in[sample], lowHalf, highHalf);
+
+                lowHalf  = compensateLowHalf[(size_t) channel].processSample(lowHalf);
+                highHalf = compensateHighHalf[(size_t) channel].processSample(highHalf);
+
+                splitLow.processSample(channel, lowHalf, lowData[sample], lowMidData[sample]);
+                splitHigh.processSample(channel, highHalf, presData[sample], airData[sample]);
+            }
+
+            // As juce::dsp::IIR::Filter::process() does after each block
+            splitMid.snapToZero(channel);
+            splitLow.snapToZero(channel);
+            splitHigh.snapToZero(channel);
+            compensateLowHalf[(size_t) channel].snapToZero();
+            compensateHighHalf[(size_t) channel].snapToZero();
+        }
+
+        for (int b = 0; b < numBands; ++b)
+        {
+            float sum = 0.0f;
+            for (int channel = 0; channel < channelsToProcess; ++channel)
+                sum += bands[b].getRMSLevel(channel, 0, numSamples);
+
+            bandRMS[(size_t) b] = channelsToProcess > 0 ? sum / (float) channelsToProcess : 0.0f;
+        }
+    }
+
+    const float* getBandReadPointer(Band band, int channel) const { return bands[band].getReadPointer(channel); }
+    float* getBandWritePointer(Band band, int channel)            { return bands[band].getWritePointer(channel); }
+
+    // Block RMS of a band, averaged over the processed channels.
+    float getBandRMS(Band band) const { return bandRMS[(size_t) band]; }
+
+    int getNumProcessedChannels() const { return processedChannels; }
+    int getNumProcessedSamples() const  { return processedSamples; }
+
+private:
+    int numChannels = 0;
+    int maxBlockSize = 0;
+    int processedChannels = 0;
+    int processedSamples = 0;
+
+    // One Linkwitz-Riley crossover per channel, on the cache's shared coefficients
+    struct Split
+    {
+        void prepare(const DspTableCache::Crossover& crossover, int numChannels)
+        {
+            filters.resize((size_t) numChannels);
+            for (auto& f : filters)
+            {
+                f[0].coefficients = f[1].coefficients = crossover.lowPass;
+                f[2].coefficients = f[3].coefficients = crossover.highPass;
+            }
+        }
+
+        void reset()
+        {
+            for (auto& f : filters)
+                for (auto& section : f)
+                    section.reset();
+        }
+
+        void snapToZero(int channel)
+        {
+            for (auto& section : filters[(size_t) channel])
+                section.snapToZero();
+        }
+
+        void processSample(int channel, float input, float& low, float& high)
+        {
+            auto& f = filters[(size_t) channel];
+            low  = f[1].processSample(f[0].processSample(input));
+            high = f[3].processSample(f[2].processSample(input));
+        }
+
+        std::vector<std::array<juce::dsp::IIR::Filter<float>, 4>> filters; // Low, low, high, high
+    };
+
+    juce::SharedResourcePointer<DspTableCache> tables;
+    Split splitMid, splitLow, splitHigh;
+    std::vector<juce::dsp::IIR::Filter<float>> compensateLowHalf, compensateHighHalf;
+
+    juce::AudioBuffer<float> bands[numBands]; // Views onto scratch memory
+    std::array<std::vector<float*>, numBands> channelPointers;
+    std::array<float, numBands> bandRMS {};
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (BandSplitter)
+};
@@ -0,0 +1,235 @@
+/*
+  ==============================================================================
+
+    BinaryStateCodec.h
+    Fixed-layout binary plugin state, written and read straight from the
+    parameters and A/B preset slots without building a ValueTree or XML DOM.
+
+    Layout (little-endian):
+        char[4]  magic "VARK"
+        uint16   format version
+        uint16   entry count
+        entries: uint32 FNV-1a hash of the parameter ID, float32 plain value
+        char[4]  "SLOT"
+        uint16   slot count
+        per slot: uint16 field count (0 while the slot is empty), then
+                  uint32 FNV-1a hash of the RackSettings field name, float32 value
+
+    Unknown hashes are skipped and missing parameters fall back to their
+    defaults, so states survive parameters being added or removed. The
+    slots are trailing data that older readers ignore; a state without them
+    leaves both slots empty.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "PresetSlots.h"
+
+class BinaryStateCodec
+{
+public:
+    static constexpr juce::uint16 currentVersion = 1;
+    static constexpr size_t headerSize = 8;
+    static constexpr size_t entrySize = 8;
+
+    explicit BinaryStateCodec(juce::AudioProcessor& processor)
+    {
+        for (auto* p : processor.getParameters())
+            if (auto* ranged = dynamic_cast<juce::RangedAudioParameter*>(p))
+                entries.push_back({ hashID(ranged->getParameterID().toRawUTF8()), ranged });
+
+        std::sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) { return a.hash < b.hash; });
+
+        // Two IDs sharing a hash would silently swap values; rename one if this fires
+        for (size_t i = 1; i < entries.size(); ++i)
+            jassert (entries[i - 1].hash != entries[i].hash);
+
+        RackSettings probe;
+        RackSettings::visitFields(probe, [this](const char*, auto&) { ++numSlotFields; });
+    }
+
+    ~BinaryStateCodec() {}
+
+    void write(juce::MemoryBlock& destData, const PresetSlots& slots) const
+    {
+        size_t size = headerSize + entries.size() * entrySize + slotsHeaderSize;
+        for (int i = 0; i < PresetSlots::numSlots; ++i)
+            size += 2 + (slots.isStored((PresetSlots::Slot) i) ? numSlotFields * entrySize : 0);
+
+        destData.setSize(size, false);
+        auto* out = static_cast<char*>(destData.getData());
+
+        std::memcpy(out, magic, 4);
+        writeUInt16(out + 4, currentVersion);
+        writeUInt16(out + 6, (juce::uint16) entries.size());
+        out += headerSize;
+
+        for (const auto& e : entries)
+        {
+            writeUInt32(out, e.hash);
+            writeFloat(out + 4, e.parameter->convertFrom0to1(e.parameter->getValue()));
+            out += entrySize;
+        }
+
+        std::memcpy(out, slotsTag, 4);
+        writeUInt16(out + 4, (juce::uint16) PresetSlots::numSlots);
+        out += slotsHeaderSize;
+
+        for (int i = 0; i < PresetSlots::numSlots; ++i)
+        {
+            const auto slot = (PresetSlots::Slot) i;
+            const bool stored = slots.isStored(slot);
+            writeUInt16(out, (juce::uint16) (stored ? numSlotFields : 0));
+            out += 2;
+
+            if (stored)
+            {
+                RackSettings::visitFields(slots.getStored(slot), [&out](const char* name, const auto& field)
+                {
+                    writeUInt32(out, hashID(name));
+                    writeFloat(out + 4, (float) field);
+                    out += entrySize;
+                });
+            }
+        }
+    }
+
+    static bool isBinaryState(const void* data, int sizeInBytes)
+    {
+        return sizeInBytes >= (int) headerSize && std::memcmp(data, magic, 4) == 0;
+    }
+
+    // Returns false if the data isn't a state this version can read
+    bool read(const void* data, int sizeInBytes, PresetSlots& slots)
+    {
+        if (! isBinaryState(data, sizeInBytes))
+            return false;
+
+        auto* in = static_cast<const char*>(data);
+        auto version = readUInt16(in + 4);
+        auto numEntries = (size_t) readUInt16(in + 6);
+
+        if (version > currentVersion || headerSize + numEntries * entrySize > (size_t) sizeInBytes)
+            return false;
+
+        for (auto& e : entries)
+            e.found = false;
+
+        in += headerSize;
+        for (size_t i = 0; i < numEntries; ++i, in += entrySize)
+        {
+            auto hash = readUInt32(in);
+            auto it = std::lower_bound(entries.begin(), entries.end(), hash,
+                                       [](const Entry& e, juce::uint32 h) { return e.hash < h; });
+
+            if (it != entries.end() && it->hash == hash)
+            {
+                setIfChanged(*it->parameter, it->parameter->convertTo0to1(readFloat(in + 4)));
+                it->found = true;
+            }
+        }
+
+        for (auto& e : entries)
+            if (! e.found)
+                setIfChanged(*e.parameter, e.parameter->getDefaultValue());
+
+        readSlots(in, static_cast<const char*>(data) + sizeInBytes, slots);
+        return true;
+    }
+
+private:
+    struct Entry
+    {
+        juce::uint32 hash;
+        juce::RangedAudioParameter* parameter;
+        bool found = false;
+    };
+
+    static constexpr char magic[4] = { 'V', 'A', 'R', 'K' };
+    static constexpr char slotsTag[4] = { 'S', 'L', 'O', 'T' };
+    static constexpr size_t slotsHeaderSize = 6;
+
+    // Slots missing or cut short in the data are left empty
+    static void readSlots(const char* in, const char* end, PresetSlots& slots)
+    {
+        int numSaved = 0;
+        if (end - in >= (std::ptrdiff_t) slotsHeaderSize && std::memcmp(in, slotsTag, 4) == 0)
+        {
+            numSaved = readUInt16(in + 4);
+            in += slotsHeaderSize;
+        }
+
+        for (int i = 0; i < PresetSlots::numSlots; ++i)
+        {
+            const auto slot = (PresetSlots::Slot) i;
+            size_t numFields = 0;
+
+            if (i < numSaved && end - in >= 2)
+            {
+                numFields = readUInt16(in);
+                in += 2;
+            }
+
+            if ((size_t) (end - in) < numFields * entrySize)
+            {
+                in = end;
+                numFields = 0;
+            }
+
+            if (numFields == 0)
+            {
+                slots.clear(slot);
+                continue;
+            }
+
+            RackSettings settings;
+            for (size_t f = 0; f < numFields; ++f, in += entrySize)
+            {
+                const auto hash = readUInt32(in);
+                const auto value = readFloat(in + 4);
+
+                RackSettings::visitFields(settings, [hash, value](const char* name, auto& field)
+                {
+                    if (hashID(name) == hash)
+                        field = (std::decay_t<decltype(field)>) value;
+                });
+            }
+
+            slots.store(slot, settings);
+        }
+    }
+
+    // Untouched parameters don't notify the host, which keeps large session loads quiet
+    static void setIfChanged(juce::RangedAudioParameter& parameter, float normalisedValue)
+    {
+        if (parameter.getValue() != normalisedValue)
+            parameter.setValueNotifyingHost(normalisedValue);
+    }
+
+    static juce::uint32 hashID(const char* id)
+    {
+        juce::uint32 h = 2166136261u;
+        for (auto* c = id; *c != 0; ++c)
+        {
+            h ^= (juce::uint32) (unsigned char) *c;
+            h *= 16777619u;
+        }
+        return h;
+    }
+
+    static void writeUInt16(char* p, juce::uint16 v) { v = juce::ByteOrder::swapIfBigEndian(v); std::memcpy(p, &v, 2); }
+    static void writeUInt32(char* p, juce::uint32 v) { v = juce::ByteOrder::swapIfBigEndian(v); std::memcpy(p, &v, 4); }
+    static void writeFloat(char* p, float f)          { juce::uint32 v; std::memcpy(&v, &f, 4); writeUInt32(p, v); }
+
+    static juce::uint16 readUInt16(const char* p) { juce::uint16 v; std::memcpy(&v, p, 2); return juce::ByteOrder::swapIfBigEndian(v); }
+    static juce::uint32 readUInt32(const char* p) { juce::uint32 v; std::memcpy(&v, p, 4); return juce::ByteOrder::swapIfBigEndian(v); }
+    static float readFloat(const char* p)          { auto v = readUInt32(p); float f; std::memcpy(&f, &v, 4); return f; }
+
+    std::vector<Entry> entries; // Sorted by hash
+    size_t numSlotFields = 0;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (BinaryStateCodec)
+};
@@ -0,0 +1,187 @@
+/*
+  ==============================================================================
+
+    BypassManager.h
+    Click-free bypass for the switchable stages of the chain. Toggling a
+    stage crossfades between its input and output over a short ramp; a
+    fully bypassed stage is not run at all and only keeps the last few ms
+    of its input, which are replayed through it to warm its filter and
+    reverb state before it fades back in.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+class BypassManager
+{
+public:
+    enum Stage
+    {
+        dynamics = 0,
+        eq,
+        harmonics,
+        shift,
+        space,
+        numStages
+    };
+
+    static constexpr double rampSeconds = 0.01;    // Crossfade length
+    static constexpr double preRollSeconds = 0.005; // Input replayed into a stage before it fades in
+
+    BypassManager() {}
+    ~BypassManager() {}
+
+    void prepare(const juce::dsp::ProcessSpec& spec)
+    {
+        numChannels = (int) spec.numChannels;
+        maxBlockSize = (int) spec.maximumBlockSize;
+        rampLength = juce::jmax(1, juce::roundToInt(spec.sampleRate * rampSeconds));
+        preRollLength = juce::jmax(1, juce::roundToInt(spec.sampleRate * preRollSeconds));
+
+        for (auto& s : stages)
+        {
+            s.history.setSize(numChannels, preRollLength);
+            s.history.clear();
+            s.historyPos = 0;
+            s.gain = s.enabled ? 1.0f : 0.0f;
+        }
+
+        warmChannels.resize((size_t) numChannels);
+        fadeChannels.resize((size_t) numChannels);
+    }
+
+    // Copy of a stage's input while it crossfades, from the owner's ScratchArena
+    static size_t getScratchSize(const juce::dsp::ProcessSpec& spec) { return (size_t) (spec.numChannels * spec.maximumBlockSize); }
+
+    void setScratch(float* memory)
+    {
+        for (int channel = 0; channel < numChannels; ++channel)
+            fadeChannels[(size_t) channel] = memory + (size_t) (channel * maxBlockSize);
+        fadeBuffer.setDataToReferTo(fadeChannels.data(), numChannels, maxBlockSize);
+    }
+
+    // Runs processStage(buffer) for an enabled or fading stage; a bypassed stage costs a short copy.
+    template <typename ProcessFunction>
+    void process(Stage id, juce::AudioBuffer<float>& buffer, bool enabled, ProcessFunction&& processStage)
+    {
+        auto& s = stages[(size_t) id];
+        const int numSamples = buffer.getNumSamples();
+        const int channels = juce::jmin(numChannels, buffer.getNumChannels());
+
+        if (enabled && ! s.enabled && s.gain == 0.0f)
+            warmUp(s, channels, processStage);
+        s.enabled = enabled;
+
+        const float target = enabled ? 1.0f : 0.0f;
+
+        if (s.gain == target)
+        {
+            if (enabled)
+                processStage(buffer);
+            else
+                recordHistory(s, buffer, channels);
+            return;
+        }
+
+        // Crossfade: the stage's own output against its input
+        for (int channel = 0; channel < channels; ++channel)
+            fadeBuffer.copyFrom(channel, 0, buffer, channel, 0, numSamples);
+
+        processStage(buffer);
+
+        const float step = (target > s.gain ? 1.0f : -1.0f) / (float) rampLength;
+        float gain = s.gain;
+
+        for (int channel = 0; channel < channels; ++channel)
+        {
+            auto* wet = buffer.getWritePointer(channel);
+            auto* dry = fadeBuffer.getReadPointer(channel);
+            gain = s.gain;
+
+            for (int i = 0; i < numSamples; ++i)
+            {
+                gain = juce::jlimit(0.0f, 1.0f, gain + step);
+                wet[i] = dry[i] + gain * (wet[i] - dry[i]);
+            }
+        }
+
+        s.gain = gain;
+
+        if (! enabled)
+            recordHistory(s, fadeBuffer, channels);
+    }
+
+    bool isBypassed(Stage id) const { return ! stages[(size_t) id].enabled && stages[(size_t) id].gain == 0.0f; }
+
+    int getNumRunningStages() const
+    {
+        int count = 0;
+        for (int id = 0; id < numStages; ++id)
+            count += isBypassed((Stage) id) ? 0 : 1;
+        return count;
+    }
+
+private:
+    struct StageState
+    {
+        bool enabled = true;
+        float gain = 1.0f;                  // 0 = bypassed, 1 = fully in
+        juce::AudioBuffer<float> history;   // Ring of the most recent bypassed input
+        int historyPos = 0;
+    };
+
+    void recordHistory(StageState& s, const juce::AudioBuffer<float>& input, int channels)
+    {
+        const int numSamples = input.getNumSamples();
+        const int count = juce::jmin(numSamples, preRollLength);
+        const int start = numSamples - count;
+
+        for (int channel = 0; channel < channels; ++channel)
+        {
+            const int first = juce::jmin(count, preRollLength - s.historyPos);
+            s.history.copyFrom(channel, s.historyPos, input, channel, start, first);
+            if (first < count)
+                s.history.copyFrom(channel, 0, input, channel, start + first, count - first);
+        }
+
+        s.historyPos = (s.historyPos + count) % preRollLength;
+    }
+
+    // Replays the history oldest first, in chunks no larger than the prepared block size,
+    // into the scratch buffer; the stage's output is thrown away
+    template <typename ProcessFunction>
+    void warmUp(StageState& s, int channels, ProcessFunction& processStage)
+    {
+        int done = 0;
+        while (done < preRollLength)
+        {
+            const int chunk = juce::jmin(maxBlockSize, preRollLength - done);
+
+            for (int channel = 0; channel < channels; ++channel)
+            {
+                for (int i = 0; i < chunk; ++i)
+                    fadeChannels[(size_t) channel][i] = s.history.getSample(channel, (s.historyPos + done + i) % preRollLength);
+                warmChannels[(size_t) channel] = fadeChannels[(size_t) channel];
+            }
+
+            juce::AudioBuffer<float> warmBuffer(warmChannels.data(), channels, chunk);
+            processStage(warmBuffer);
+            done += chunk;
+        }
+    }
+
+    std::array<StageState, numStages> stages;
+
+    int numChannels = 2;
+    int maxBlockSize = 512;
+    int rampLength = 480;
+    int preRollLength = 240;
+
+    juce::AudioBuffer<float> fadeBuffer; // View onto scratch memory
+    std::vector<float*> fadeChannels, warmChannels;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (BypassManager)
+};
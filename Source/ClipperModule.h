@@ -11,6 +11,7 @@
 
 #include <JuceHeader.h>
 #include "PressureDetector.h"
+#include "DspTableCache.h"
 
 class ClipperModule
 {
@@ -20,8 +21,9 @@ public:
 
     void prepare(const juce::dsp::ProcessSpec& spec)
     {
-        dcBlocker.prepare(spec);
-        *dcBlocker.state = *juce::dsp::IIR::Coefficients<float>::makeHighPass(spec.sampleRate, 20.0f);
+        // Every instance at this rate shares one set of DC blocker coefficients
+        dcCoefficients = tables->getHighPass(spec.sampleRate, 20.0f);
+        dcStates.assign(spec.numChannels, DCState());
         sampleRate = spec.sampleRate;
     }
 
@@ -29,6 +31,7 @@ public:
     {
         float gain = juce::Decibels::decibelsToGain(drive);
         float limit = juce::Decibels::decibelsToGain(ceiling);
+        float peakIn = 0.0f, peakOut = 0.0f;
 
         for (int channel = 0; channel < buffer.getNumChannels(); ++channel)
         {
@@ -37,24 +40,133 @@ public:
             for (int sample = 0; sample < buffer.getNumSamples(); ++sample)
             {
                 float x = data[sample] * gain;
+                peakIn = juce::jmax(peakIn, std::abs(x));
 
                 // Soft clipping transition into hard clipping
                 if (std::abs(x) > limit)
                     x = (x > 0) ? limit : -limit;
                 else if (std::abs(x) > limit * 0.7f)
-                    x = x - (0.1f * std::pow(x, 3.0f)); // Subtle cubic saturation
+                    x = x - 0.1f * (x * x * x); // Subtle cubic saturation
 
+                peakOut = juce::jmax(peakOut, std::abs(x));
                 data[sample] = x;
             }
         }
 
+        gainReductionDb = gainReductionFor(peakIn, peakOut);
+
         // Block DC offset that might build up from asymmetric clipping
-        juce::dsp::AudioBlock<float> block(buffer);
-        juce::dsp::ProcessContextReplacing<float> context(block);
-        dcBlocker.process(context);
+        const auto* c = dcCoefficients->getRawCoefficients();
+        for (size_t channel = 0; channel < juce::jmin((size_t) buffer.getNumChannels(), dcStates.size()); ++channel)
+        {
+            auto* data = buffer.getWritePointer((int) channel);
+            float lv1 = dcStates[channel].lv1, lv2 = dcStates[channel].lv2;
+
+            for (int sample = 0; sample < buffer.getNumSamples(); ++sample)
+            {
+                float input = data[sample];
+                float output = input * c[0] + lv1;
+                lv1 = input * c[1] - output * c[3] + lv2;
+                lv2 = input * c[2] - output * c[4];
+                data[sample] = output;
+            }
+
+            dcStates[channel] = { snapToZero(lv1), snapToZero(lv2) };
+        }
     }
 
+    using Lanes = juce::dsp::SIMDRegister<float>;
+    static constexpr int numLanes = (int) Lanes::SIMDNumElements;
+
+    // The Wall for up to numLanes instances at once, one per SIMD lane, all prepared at the
+    // same rate. channels[c][i] holds sample i of channel c for every instance; drive and
+    // ceiling are per instance. Lane for lane this is process()'s arithmetic, so each
+    // instance ends up exactly where process() would have left it.
+    static void processPacked(ClipperModule* const* modules, int numModules, Lanes* const* channels,
+                              int numChannels, int numSamples, const float* drive, const float* ceiling)
+    {
+        jassert (numModules > 0 && numModules <= numLanes);
+
+        // Spare lanes run on silence
+        auto gain = Lanes::expand(1.0f), limit = Lanes::expand(1.0f), lowerLimit = Lanes::expand(-1.0f), knee = Lanes::expand(0.7f);
+        for (int m = 0; m < numModules; ++m)
+        {
+            const float l = juce::Decibels::decibelsToGain(ceiling[m]);
+            gain.set((size_t) m, juce::Decibels::decibelsToGain(drive[m]));
+            limit.set((size_t) m, l);
+            lowerLimit.set((size_t) m, -l);
+            knee.set((size_t) m, l * 0.7f);
+        }
+
+        const auto tenth = Lanes::expand(0.1f);
+        auto peakIn = Lanes::expand(0.0f), peakOut = Lanes::expand(0.0f);
+
+        const auto* c = modules[0]->dcCoefficients->getRawCoefficients();
+        const auto b0 = Lanes::expand(c[0]), b1 = Lanes::expand(c[1]), b2 = Lanes::expand(c[2]);
+        const auto a1 = Lanes::expand(c[3]), a2 = Lanes::expand(c[4]);
+
+        for (int channel = 0; channel < numChannels; ++channel)
+        {
+            auto lv1 = Lanes::expand(0.0f), lv2 = Lanes::expand(0.0f);
+            for (int m = 0; m < numModules; ++m)
+            {
+                jassert (modules[m]->dcCoefficients == modules[0]->dcCoefficients);
+                lv1.set((size_t) m, modules[m]->dcStates[(size_t) channel].lv1);
+                lv2.set((size_t) m, modules[m]->dcStates[(size_t) channel].lv2);
+            }
+
+            auto* data = channels[channel];
+            for (int sample = 0; sample < numSamples; ++sample)
+            {
+                auto x = data[sample] * gain;
+                auto level = Lanes::abs(x);
+                peakIn = Lanes::max(peakIn, level);
+
+                // Past the knee but within the limit saturates; past the limit clamps. The
+                // ceiling is at most 0 dB, so saturation never leaves the limit and the clamp
+                // only moves the lanes past it.
+                auto saturating = Lanes::greaterThan(level, knee) & ~Lanes::greaterThan(level, limit);
+                x = x - ((tenth * (x * x * x)) & saturating);
+                x = Lanes::min(limit, Lanes::max(lowerLimit, x));
+                peakOut = Lanes::max(peakOut, Lanes::abs(x));
+
+                auto output = x * b0 + lv1;
+                lv1 = x * b1 - output * a1 + lv2;
+                lv2 = x * b2 - output * a2;
+                data[sample] = output;
+            }
+
+            for (int m = 0; m < numModules; ++m)
+                modules[m]->dcStates[(size_t) channel] = { snapToZero(lv1.get((size_t) m)), snapToZero(lv2.get((size_t) m)) };
+        }
+
+        for (int m = 0; m < numModules; ++m)
+            modules[m]->gainReductionDb = gainReductionFor(peakIn.get((size_t) m), peakOut.get((size_t) m));
+    }
+
+    // How far the clipper pulled the block's driven peak down, in dB
+    float getGainReductionDb() const { return gainReductionDb; }
+
 private:
+    static float gainReductionFor(float peakIn, float peakOut)
+    {
+        return peakIn > 0.0f ? juce::Decibels::gainToDecibels(peakIn / juce::jmax(peakOut, 1.0e-6f)) : 0.0f;
+    }
+
+    // As juce::dsp::IIR::Filter flushes its state after each block
+    static float snapToZero(float value) { return (value < -1.0e-8f || value > 1.0e-8f) ? value : 0.0f; }
+
     double sampleRate = 44100.0;
-    juce::dsp::ProcessorDuplicator<juce::dsp::IIR::Filter<float>, juce::dsp::IIR::Coefficients<float>> dcBlocker;
+    float gainReductionDb = 0.0f;
+    juce::SharedResourcePointer<DspTableCache> tables;
+
+    // The DC blocker is the second-order case of juce::dsp::IIR::Filter written out, so
+    // processPacked() can carry each instance's state in a lane
+    struct DCState
+    {
+        float lv1 = 0.0f, lv2 = 0.0f;
+    };
+
+    juce::dsp::IIR::Coefficients<float>::Ptr dcCoefficients;
+    std::vector<DCState> dcStates;
 };
@@ -0,0 +1,52 @@
+/*
+  ==============================================================================
+
+    DerivedState.h
+    Dirty tracking for per-block derived values (filter coefficients, reverb
+    settings, ratios). A module lists the parameters and detector signals a
+    value depends on, each with the smallest change that would be audible in
+    the result; the value is recomputed only once an input moves that far
+    from where it was last computed.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+template <size_t NumInputs>
+class DerivedState
+{
+public:
+    using Inputs = std::array<float, NumInputs>;
+
+    explicit DerivedState(const Inputs& thresholdsToUse) : thresholds(thresholdsToUse) {}
+
+    // True if the derived value needs recomputing; the inputs then become the new reference
+    bool needsUpdate(const Inputs& inputs)
+    {
+        bool dirty = ! valid;
+        for (size_t i = 0; i < NumInputs && ! dirty; ++i)
+            dirty = std::abs(inputs[i] - reference[i]) > thresholds[i];
+
+        if (! dirty)
+            return false;
+
+        reference = inputs;
+        valid = true;
+        ++recomputeCount;
+        return true;
+    }
+
+    // Forces the next needsUpdate() to recompute, e.g. after prepare()
+    void invalidate() { valid = false; }
+
+    juce::uint32 getRecomputeCount() const { return recomputeCount; }
+
+private:
+    Inputs thresholds;
+    Inputs reference {};
+    bool valid = false;
+    juce::uint32 recomputeCount = 0;
+};
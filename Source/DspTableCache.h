@@ -0,0 +1,135 @@
+/*
+  ==============================================================================
+
+    DspTableCache.h
+    Process-wide cache of immutable DSP data: analysis windows and fixed
+    filter coefficients (the band crossovers and the Wall's DC blocker),
+    keyed by size or sample rate. The first instance to ask builds an entry;
+    later instances share it read-only. Entries are reference counted and
+    freed when the last instance using them goes away.
+
+    Reach it through juce::SharedResourcePointer<DspTableCache>. Lookups
+    lock, so call them from prepare(), never from the audio thread.
+
+    FFT plans are not shared: JUCE's fallback engine (no IPP or FFTW) takes
+    a lock inside every transform, so each consumer owns its own plan.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+class DspTableCache
+{
+public:
+    enum class Window
+    {
+        hann,     // juce::dsp::WindowingFunction's Hann, for analysis-only STFTs
+        sqrtHann  // Periodic root-Hann, for analysis + resynthesis pairs
+    };
+
+    DspTableCache() {}
+    ~DspTableCache() {}
+
+    std::shared_ptr<const std::vector<float>> getWindow(Window type, int size)
+    {
+        const std::lock_guard<std::mutex> lock(mutex);
+        return findOrBuild(windows, std::make_pair((int) type, size), [type, size]
+        {
+            std::vector<float> table((size_t) size, 0.0f);
+
+            if (type == Window::hann)
+            {
+                juce::dsp::WindowingFunction<float>::fillWindowingTables(table.data(), (size_t) size,
+                                                                         juce::dsp::WindowingFunction<float>::hann, false);
+            }
+            else
+            {
+                for (int i = 0; i < size; ++i)
+                    table[(size_t) i] = std::sqrt(0.5f - 0.5f * std::cos(juce::MathConstants<float>::twoPi * (float) i / (float) size));
+            }
+
+            return std::make_shared<const std::vector<float>>(std::move(table));
+        });
+    }
+
+    // Second-order Butterworth high-pass, e.g. the Wall's DC blocker
+    juce::dsp::IIR::Coefficients<float>::Ptr getHighPass(double sampleRate, float frequency)
+    {
+        const std::lock_guard<std::mutex> lock(mutex);
+        return findOrMakeFilter(Filter::highPass, sampleRate, frequency);
+    }
+
+    // A fourth-order Linkwitz-Riley crossover as biquads: each side runs its Butterworth
+    // section twice, and the two sides sum to the second-order all-pass
+    struct Crossover
+    {
+        juce::dsp::IIR::Coefficients<float>::Ptr lowPass, highPass, allPass;
+    };
+
+    Crossover getCrossover(double sampleRate, float frequency)
+    {
+        const std::lock_guard<std::mutex> lock(mutex);
+        return { findOrMakeFilter(Filter::lowPass, sampleRate, frequency),
+                 findOrMakeFilter(Filter::highPass, sampleRate, frequency),
+                 findOrMakeFilter(Filter::allPass, sampleRate, frequency) };
+    }
+
+    // Entries currently shared by at least one instance
+    int getNumLiveEntries()
+    {
+        const std::lock_guard<std::mutex> lock(mutex);
+        int count = 0;
+        for (auto& e : windows) count += e.second.expired() ? 0 : 1;
+        for (auto& e : filters) count += e.second->getReferenceCount() > 1 ? 1 : 0;
+        return count;
+    }
+
+private:
+    enum class Filter { lowPass, highPass, allPass };
+
+    juce::dsp::IIR::Coefficients<float>::Ptr findOrMakeFilter(Filter type, double sampleRate, float frequency)
+    {
+        using Coefficients = juce::dsp::IIR::Coefficients<float>;
+
+        // Coefficients are JUCE reference-counted objects; drop the ones only the cache still holds
+        for (auto it = filters.begin(); it != filters.end();)
+            it = it->second->getReferenceCount() == 1 ? filters.erase(it) : std::next(it);
+
+        auto key = std::make_tuple((int) type, sampleRate, frequency);
+        auto found = filters.find(key);
+        if (found != filters.end())
+            return found->second;
+
+        // All at the Butterworth Q
+        auto coefficients = type == Filter::lowPass  ? Coefficients::makeLowPass(sampleRate, frequency)
+                          : type == Filter::highPass ? Coefficients::makeHighPass(sampleRate, frequency)
+                                                     : Coefficients::makeAllPass(sampleRate, frequency);
+        filters[key] = coefficients;
+        return coefficients;
+    }
+
+    template <typename Key, typename Value, typename Builder>
+    static std::shared_ptr<const Value> findOrBuild(std::map<Key, std::weak_ptr<const Value>>& map, const Key& key, Builder&& build)
+    {
+        // Forget entries whose last user has gone, so the map doesn't grow with every
+        // sample rate and size ever asked for
+        for (auto it = map.begin(); it != map.end();)
+            it = it->second.expired() && it->first != key ? map.erase(it) : std::next(it);
+
+        if (auto existing = map[key].lock())
+            return existing;
+
+        std::shared_ptr<const Value> created = build();
+        map[key] = created;
+        return created;
+    }
+
+    std::mutex mutex;
+    std::map<std::pair<int, int>, std::weak_ptr<const std::vector<float>>> windows;
+    std::map<std::tuple<int, double, float>, juce::dsp::IIR::Coefficients<float>::Ptr> filters;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (DspTableCache)
+};
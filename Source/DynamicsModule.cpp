@@ -22,12 +22,26 @@ void DynamicsModule::prepare(const juce::dsp::ProcessSpec& spec)
 {
     sampleRate = spec.sampleRate;
     smoothedGain.reset(sampleRate, 0.01); // Fast response for dynamics
+    deReverb.prepare(spec);
+}
+
+void DynamicsModule::processDeReverb(juce::AudioBuffer<float>& buffer, bool enabled)
+{
+    // Fully engaged at the bottom of the Function knob, handing over to the
+    // expander as it morphs towards 0.25; Sustain Cut sets the depth
+    float depth = 0.0f;
+    if (enabled && functionAmount < 0.25f)
+        depth = sustainCut * (1.0f - functionAmount * 4.0f);
+
+    deReverb.process(buffer, depth);
 }
 
 void DynamicsModule::process(juce::AudioBuffer<float>& buffer, const PressureDetector& detector)
 {
     float intensity = detector.getIntensity();
     float density = detector.getDensity();
+    const float* transient = detector.getTransientLane();
+    float minGain = 1.0f;
 
     for (int sample = 0; sample < buffer.getNumSamples(); ++sample)
     {
@@ -38,7 +52,9 @@ void DynamicsModule::process(juce::AudioBuffer<float>& buffer, const PressureDet
         {
             float morph = functionAmount * 4.0f; // 0 to 1
             float gateThreshold = 0.15f * (1.0f - morph);
-            float gateGain = (intensity > gateThreshold) ? 1.0f : (1.0f - sustainCut);
+            // Consonant attacks open the gate even when the block level sits under the threshold
+            bool open = intensity > gateThreshold || transient[sample] > 0.25f;
+            float gateGain = open ? 1.0f : (1.0f - sustainCut);
             float expandGain = 0.5f + (intensity * 1.5f);
             targetGain = gateGain * (1.0f - morph) + expandGain * morph;
         }
@@ -70,10 +86,13 @@ void DynamicsModule::process(juce::AudioBuffer<float>& buffer, const PressureDet
 
         smoothedGain.setTargetValue(targetGain);
         float currentGain = smoothedGain.getNextValue();
+        minGain = juce::jmin(minGain, std::abs(currentGain));
 
         for (int channel = 0; channel < buffer.getNumChannels(); ++channel)
         {
             buffer.setSample(channel, sample, buffer.getSample(channel, sample) * currentGain);
         }
     }
+
+    gainReductionDb = -juce::Decibels::gainToDecibels(minGain, -60.0f);
 }
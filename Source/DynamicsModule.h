@@ -12,6 +12,7 @@
 
 #include <JuceHeader.h>
 #include "PressureDetector.h"
+#include "SpectralDeReverb.h"
 
 class DynamicsModule
 {
@@ -22,13 +23,27 @@ public:
     void prepare(const juce::dsp::ProcessSpec& spec);
     void process(juce::AudioBuffer<float>& buffer, const PressureDetector& detector);
 
+    // Spectral de-reverb for the low end of the Function range. It adds a frame of
+    // latency, so the chain only runs it while engaged; then call it even when the
+    // module is bypassed, so the latency holds.
+    void processDeReverb(juce::AudioBuffer<float>& buffer, bool enabled);
+    bool isDeReverbEngaged() const { return deReverbEnabled; }
+    void resetDeReverb() { deReverb.reset(); }
+
+    int getLatencySamples() const { return deReverb.getLatencySamples(); }
+    float getGainReductionDb() const { return gainReductionDb; } // Deepest broadband cut in the last block
+    float getDeReverbReductionDb() const { return deReverb.getGainReductionDb(); }
+
     // Parameters (would normally be in APVTS, but keeping it simple for now)
     float functionAmount = 0.5f; // 0.0 to 1.0 (Gate -> Inversion)
     float sustainCut = 0.5f;
+    bool deReverbEnabled = false; // Set from the unscaled Function and Sustain Cut knobs
 
 private:
     double sampleRate = 44100.0;
     juce::LinearSmoothedValue<float> smoothedGain { 1.0f };
+    SpectralDeReverb deReverb;
+    float gainReductionDb = 0.0f;
 
     float calculateGain(float inputLevel, float intensity, float density);
 };
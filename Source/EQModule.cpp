@@ -23,6 +23,8 @@ void EQModule::prepare(const juce::dsp::ProcessSpec& spec)
     sampleRate = spec.sampleRate;
     scoopFilter.prepare(spec);
     biteFilter.prepare(spec);
+    scoopState.invalidate();
+    biteState.invalidate();
 }
 
 void EQModule::process(juce::AudioBuffer<float>& buffer, const PressureDetector& detector)
@@ -32,15 +34,21 @@ void EQModule::process(juce::AudioBuffer<float>& buffer, const PressureDetector&
 
     // 1. Dynamic Scoop (Low-Mid Mud Removal) - The "Auto-Engineer"
     // Deepen scoop when density is high (thick low vocals) or timbre shows muddy resonance
-    float autoScoop = scoopAmount * (0.4f + density * 0.6f + timbre * 0.3f);
-    float scoopGain = juce::Decibels::decibelsToGain(-32.0f * juce::jlimit(0.0f, 1.0f, autoScoop));
-    *scoopFilter.state = *juce::dsp::IIR::Coefficients<float>::makePeakFilter(sampleRate, 300.0f, 0.8f, scoopGain);
+    if (scoopState.needsUpdate({ scoopAmount, density, timbre }))
+    {
+        float autoScoop = scoopAmount * (0.4f + density * 0.6f + timbre * 0.3f);
+        float scoopGain = juce::Decibels::decibelsToGain(-32.0f * juce::jlimit(0.0f, 1.0f, autoScoop));
+        *scoopFilter.state = juce::dsp::IIR::ArrayCoefficients<float>::makePeakFilter(sampleRate, 300.0f, 0.8f, scoopGain);
+    }
 
     // 2. Dynamic Bite (High-Mid Aggression)
     // Increase bite for intelligibility, but intelligently ease off if the detector hears piercing harshness
-    float autoBite = biteAmount * (1.2f - timbre);
-    float biteGain = juce::Decibels::decibelsToGain(18.0f * juce::jlimit(0.0f, 1.0f, autoBite));
-    *biteFilter.state = *juce::dsp::IIR::Coefficients<float>::makePeakFilter(sampleRate, 3200.0f, 0.6f, biteGain);
+    if (biteState.needsUpdate({ biteAmount, timbre }))
+    {
+        float autoBite = biteAmount * (1.2f - timbre);
+        float biteGain = juce::Decibels::decibelsToGain(18.0f * juce::jlimit(0.0f, 1.0f, autoBite));
+        *biteFilter.state = juce::dsp::IIR::ArrayCoefficients<float>::makePeakFilter(sampleRate, 3200.0f, 0.6f, biteGain);
+    }
 
     juce::dsp::AudioBlock<float> block(buffer);
     juce::dsp::ProcessContextReplacing<float> context(block);
@@ -12,6 +12,7 @@
 
 #include <JuceHeader.h>
 #include "PressureDetector.h"
+#include "DerivedState.h"
 
 class EQModule
 {
@@ -25,9 +26,17 @@ public:
     float scoopAmount = 0.5f;
     float biteAmount = 0.5f;
 
+    // Coefficient rebuilds since construction, for the telemetry
+    juce::uint32 getRecomputeCount() const { return scoopState.getRecomputeCount() + biteState.getRecomputeCount(); }
+
 private:
     double sampleRate = 44100.0;
 
     juce::dsp::ProcessorDuplicator<juce::dsp::IIR::Filter<float>, juce::dsp::IIR::Coefficients<float>> scoopFilter;
     juce::dsp::ProcessorDuplicator<juce::dsp::IIR::Filter<float>, juce::dsp::IIR::Coefficients<float>> biteFilter;
+
+    // Rebuilt only once an input moves ~0.1 dB worth of filter gain:
+    // scoop depends on amount, density and timbre; bite on amount and timbre
+    DerivedState<3> scoopState { { 0.003f, 0.005f, 0.01f } };
+    DerivedState<2> biteState  { { 0.005f, 0.005f } };
 };
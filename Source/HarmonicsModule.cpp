@@ -21,8 +21,7 @@ HarmonicsModule::~HarmonicsModule()
 void HarmonicsModule::prepare(const juce::dsp::ProcessSpec& spec)
 {
     sampleRate = spec.sampleRate;
-    clarityHPF.prepare(spec);
-    sidechainBuffer.setSize(spec.numChannels, spec.maximumBlockSize);
+    bandSplitter.prepare(spec);
 }
 
 void HarmonicsModule::process(juce::AudioBuffer<float>& buffer, const PressureDetector& detector)
@@ -40,38 +39,30 @@ void HarmonicsModule::process(juce::AudioBuffer<float>& buffer, const PressureDe
     // Dynamically shaped to avoid amplifying harsh frequencies identified by the Timbre detector.
     float clarityDrive = 1.0f + clarityAmount * 3.0f * (1.0f - timbre);
 
-    // The Clarity path is high-passed to stay in the "Air" region
-    *clarityHPF.state = *juce::dsp::IIR::Coefficients<float>::makeHighPass(sampleRate, 6000.0f);
-
-    // sidechainBuffer is pre-allocated in prepare
     int numSamples = buffer.getNumSamples();
     int numChannels = buffer.getNumChannels();
 
-    for (int i = 0; i < numChannels; ++i)
-        sidechainBuffer.copyFrom(i, 0, buffer.getReadPointer(i), numSamples);
-
-    // Process Clarity path
-    juce::dsp::AudioBlock<float> block(sidechainBuffer.getArrayOfWritePointers(), numChannels, numSamples);
-    juce::dsp::ProcessContextReplacing<float> context(block);
-    clarityHPF.process(context);
-
-    for (int i = 0; i < numChannels; ++i)
-        sidechainBuffer.applyGain(i, 0, numSamples, clarityDrive);
+    bandSplitter.process(buffer, numChannels, numSamples);
+    numChannels = bandSplitter.getNumProcessedChannels();
 
     for (int channel = 0; channel < numChannels; ++channel)
     {
-        auto* mainData = buffer.getWritePointer(channel);
-        auto* sideData = sidechainBuffer.getReadPointer(channel);
+        auto* mainData     = buffer.getWritePointer(channel);
+        auto* lowData      = bandSplitter.getBandReadPointer(BandSplitter::low, channel);
+        auto* gritData     = bandSplitter.getBandReadPointer(BandSplitter::lowMid, channel);
+        auto* presenceData = bandSplitter.getBandReadPointer(BandSplitter::presence, channel);
+        auto* airData      = bandSplitter.getBandReadPointer(BandSplitter::air, channel);
 
-        for (int sample = 0; sample < buffer.getNumSamples(); ++sample)
+        for (int sample = 0; sample < numSamples; ++sample)
         {
-            // Apply Grit to main signal
-            float input = mainData[sample] * gritDrive;
-            mainData[sample] = std::tanh(input);
+            // Apply Grit to the band just above the scoop; the low end stays clean
+            float grit = std::tanh(gritData[sample] * gritDrive);
+
+            // Add Clarity harmonics from the air band (soft clipped)
+            float clarity = std::tanh(airData[sample] * clarityDrive);
 
-            // Add Clarity harmonics (soft clipped)
-            float clarity = std::tanh(sideData[sample]);
-            mainData[sample] += clarity * clarityAmount * 0.3f;
+            mainData[sample] = lowData[sample] + grit + presenceData[sample] + airData[sample]
+                             + clarity * clarityAmount * 0.3f;
         }
     }
 }
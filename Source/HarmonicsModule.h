@@ -12,6 +12,7 @@
 
 #include <JuceHeader.h>
 #include "PressureDetector.h"
+#include "BandSplitter.h"
 
 class HarmonicsModule
 {
@@ -22,14 +23,21 @@ public:
     void prepare(const juce::dsp::ProcessSpec& spec);
     void process(juce::AudioBuffer<float>& buffer, const PressureDetector& detector);
 
+    // Band storage for the split, from the owner's ScratchArena
+    static size_t getScratchSize(const juce::dsp::ProcessSpec& spec)
+    {
+        return BandSplitter::getScratchSize((int) spec.numChannels, (int) spec.maximumBlockSize);
+    }
+    void setScratch(float* memory) { bandSplitter.setScratch(memory); }
+
     float gritAmount = 0.5f;
     float clarityAmount = 0.5f;
 
 private:
     double sampleRate = 44100.0;
 
-    // High-pass filter for clarity harmonics
-    juce::dsp::ProcessorDuplicator<juce::dsp::IIR::Filter<float>, juce::dsp::IIR::Coefficients<float>> clarityHPF;
-
-    juce::AudioBuffer<float> sidechainBuffer;
+    // Grit and Clarity each saturate their own band of the split. This is a second
+    // split of the processed audio; the detector's bands are of the unprocessed key
+    // and can't stand in for it.
+    BandSplitter bandSplitter;
 };
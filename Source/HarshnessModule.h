@@ -0,0 +1,155 @@
+/*
+  ==============================================================================
+
+    HarshnessModule.h - "TAME"
+    Spectral resonance suppressor that runs straight after the EQ. Finds
+    narrow peaks that stick out of the spectral envelope and pulls them
+    down per STFT bin, easing off the EQ's fixed Bite where it turns piercing.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "PressureDetector.h"
+#include "SpectralProcessor.h"
+
+class HarshnessModule : private SpectralProcessor
+{
+public:
+    HarshnessModule() {}
+    ~HarshnessModule() override {}
+
+    void prepare(const juce::dsp::ProcessSpec& spec)
+    {
+        // ~11 ms frames at any rate: 512 points up to 48 kHz, 1024 above
+        prepareSpectral(spec.sampleRate, (int) spec.numChannels, spec.sampleRate > 50000.0 ? 10 : 9);
+
+        const int bins = getNumBins();
+        logMag.assign((size_t) bins, 0.0f);
+        envelope.assign((size_t) bins, 0.0f);
+        targetDb.assign((size_t) bins, 0.0f);
+        binWeight.assign((size_t) bins, 0.0f);
+        gainDb.assign((size_t) bins * spec.numChannels, 0.0f);
+
+        // Only the harshness region is touched; the weight fades in and out over an octave
+        const float binHz = (float) (spec.sampleRate / getFFTSize());
+        for (int bin = 0; bin < bins; ++bin)
+        {
+            float octaveFromCentre = std::log2(juce::jmax(1.0f, (float) bin * binHz) / 4500.0f);
+            binWeight[(size_t) bin] = juce::jlimit(0.0f, 1.0f, 2.0f - std::abs(octaveFromCentre));
+        }
+
+        weightSum = 0.0f;
+        for (auto w : binWeight)
+            weightSum += w;
+
+        // Per-frame smoothing of each bin's gain: fast to cut, slow to let go
+        const float frameSeconds = (float) getHopSize() / (float) spec.sampleRate;
+        attackCoeff  = 1.0f - std::exp(-frameSeconds / 0.005f);
+        releaseCoeff = 1.0f - std::exp(-frameSeconds / 0.080f);
+
+        reductionDb = 0.0f;
+    }
+
+    void reset()
+    {
+        resetSpectral();
+        std::fill(gainDb.begin(), gainDb.end(), 0.0f);
+        reductionDb = 0.0f;
+    }
+
+    // Adds a frame of latency, so the chain only runs it while engaged; then call it
+    // even when disabled, so the latency holds.
+    bool isEngaged() const { return tameAmount > 0.0f; }
+
+    void process(juce::AudioBuffer<float>& buffer, const PressureDetector& detector, bool enabled)
+    {
+        // Harsher performances get a deeper, more sensitive cut
+        float timbre = detector.getTimbre();
+        maxCutDb    = tameAmount * (6.0f + 10.0f * timbre);
+        thresholdDb = 9.0f - 4.0f * tameAmount;
+
+        bool active = enabled && tameAmount > 0.0f;
+        if (! active && reductionDb != 0.0f)
+        {
+            std::fill(gainDb.begin(), gainDb.end(), 0.0f);
+            reductionDb = 0.0f;
+        }
+
+        processSpectral(buffer, active);
+    }
+
+    using SpectralProcessor::getLatencySamples;
+
+    // Average cut across the harshness region over the last frame, in dB (positive = cut)
+    float getGainReductionDb() const { return reductionDb; }
+
+    float tameAmount = 0.0f; // 0.0 = off, 1.0 = maximum suppression
+
+private:
+    void processSpectrum(int channel, float* bins) override
+    {
+        const int numBins = getNumBins();
+        constexpr float dbPerLn = 8.685889638f; // 20 / ln(10)
+
+        for (int bin = 0; bin < numBins; ++bin)
+        {
+            float re = bins[bin * 2], im = bins[bin * 2 + 1];
+            logMag[(size_t) bin] = 0.5f * dbPerLn * std::log(re * re + im * im + 1.0e-18f);
+        }
+
+        // Spectral envelope: forward/backward one-pole across bins, so narrow peaks stand out of it
+        constexpr float spread = 0.85f;
+        envelope[0] = logMag[0];
+        for (int bin = 1; bin < numBins; ++bin)
+            envelope[(size_t) bin] = logMag[(size_t) bin] + (envelope[(size_t) bin - 1] - logMag[(size_t) bin]) * spread;
+        for (int bin = numBins - 2; bin >= 0; --bin)
+            envelope[(size_t) bin] = envelope[(size_t) bin] + (envelope[(size_t) bin + 1] - envelope[(size_t) bin]) * spread;
+
+        // Target cut per bin. Plain contiguous loops so they auto-vectorise.
+        auto* gains = gainDb.data() + (size_t) channel * (size_t) numBins;
+        for (int bin = 0; bin < numBins; ++bin)
+        {
+            float excess = logMag[(size_t) bin] - envelope[(size_t) bin] - thresholdDb;
+            targetDb[(size_t) bin] = -juce::jmin(maxCutDb, juce::jmax(0.0f, excess) * 0.8f) * binWeight[(size_t) bin];
+        }
+
+        float sum = 0.0f;
+        for (int bin = 0; bin < numBins; ++bin)
+        {
+            float delta = targetDb[(size_t) bin] - gains[bin];
+            gains[bin] += juce::jmin(delta, 0.0f) * attackCoeff + juce::jmax(delta, 0.0f) * releaseCoeff;
+            sum += gains[bin] * binWeight[(size_t) bin];
+        }
+
+        for (int bin = 0; bin < numBins; ++bin)
+        {
+            float g = std::exp(gains[bin] / dbPerLn);
+            bins[bin * 2]     *= g;
+            bins[bin * 2 + 1] *= g;
+        }
+
+        frameReduction = juce::jmax(frameReduction, -sum / juce::jmax(1.0f, weightSum));
+    }
+
+    void frameProcessed(bool wasActive) override
+    {
+        if (wasActive)
+            reductionDb = frameReduction;
+        frameReduction = 0.0f;
+    }
+
+    std::vector<float> logMag, envelope, targetDb, binWeight, gainDb;
+
+    float attackCoeff = 0.5f, releaseCoeff = 0.1f;
+    float maxCutDb = 0.0f;
+    float thresholdDb = 9.0f;
+    float weightSum = 0.0f;
+
+    float frameReduction = 0.0f;
+    float reductionDb = 0.0f;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (HarshnessModule)
+};
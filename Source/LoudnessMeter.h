@@ -0,0 +1,218 @@
+/*
+  ==============================================================================
+
+    LoudnessMeter.h
+    Streaming ITU-R BS.1770-4 loudness: K-weighting, 100 ms sub-blocks,
+    momentary (400 ms), short-term (3 s) and gated integrated loudness.
+    The integrated value comes from a fixed histogram of gating blocks,
+    so memory and cost stay constant however long the programme runs.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+class LoudnessMeter
+{
+public:
+    static constexpr int maxChannels = 8;
+    static constexpr float silenceLUFS = -70.0f; // Also the absolute gate
+
+    LoudnessMeter() {}
+    ~LoudnessMeter() {}
+
+    void prepare(double sampleRate, int numChannels)
+    {
+        channels = juce::jlimit(1, maxChannels, numChannels);
+        subBlockLength = juce::jmax(1, juce::roundToInt(sampleRate * 0.1));
+
+        // K-weighting, stage 1: high-frequency shelf (+4 dB above ~1.7 kHz)
+        {
+            const double f0 = 1681.974450955533, gainDb = 3.999843853973347, q = 0.7071752369554196;
+            const double k = std::tan(juce::MathConstants<double>::pi * f0 / sampleRate);
+            const double vh = std::pow(10.0, gainDb / 20.0);
+            const double vb = std::pow(vh, 0.4996667741545416);
+            const double a0 = 1.0 + k / q + k * k;
+            shelf = { (float) ((vh + vb * k / q + k * k) / a0), (float) (2.0 * (k * k - vh) / a0),
+                      (float) ((vh - vb * k / q + k * k) / a0), (float) (2.0 * (k * k - 1.0) / a0),
+                      (float) ((1.0 - k / q + k * k) / a0) };
+        }
+
+        // K-weighting, stage 2: the RLB high-pass
+        {
+            const double f0 = 38.13547087602444, q = 0.5003270373238773;
+            const double k = std::tan(juce::MathConstants<double>::pi * f0 / sampleRate);
+            const double a0 = 1.0 + k / q + k * k;
+            highPass = { 1.0f, -2.0f, 1.0f, (float) (2.0 * (k * k - 1.0) / a0), (float) ((1.0 - k / q + k * k) / a0) };
+        }
+
+        // Bin centres of the gating histogram, as mean-square energies
+        for (int bin = 0; bin < histogramBins; ++bin)
+            binEnergy[(size_t) bin] = lufsToEnergy(silenceLUFS + (float) bin * histogramStep);
+
+        reset();
+    }
+
+    void reset()
+    {
+        for (auto& s : filterState)
+            s = {};
+
+        subBlockSum.fill(0.0);
+        subBlockCount = 0;
+
+        subBlocks.fill(0.0);
+        subBlockPos = 0;
+        numSubBlocks = 0;
+
+        histogram.fill(0);
+        momentary = shortTerm = integrated = silenceLUFS;
+    }
+
+    void process(const juce::AudioBuffer<float>& buffer)
+    {
+        const int numChannels = juce::jmin(channels, buffer.getNumChannels());
+        const int numSamples = buffer.getNumSamples();
+
+        int start = 0;
+        while (start < numSamples)
+        {
+            int chunk = juce::jmin(numSamples - start, subBlockLength - subBlockCount);
+
+            for (int ch = 0; ch < numChannels; ++ch)
+                subBlockSum[(size_t) ch] += filterAndSquare(filterState[(size_t) ch], buffer.getReadPointer(ch, start), chunk);
+
+            subBlockCount += chunk;
+            start += chunk;
+
+            if (subBlockCount == subBlockLength)
+                completeSubBlock(numChannels);
+        }
+    }
+
+    float getMomentaryLUFS() const  { return momentary; }
+    float getShortTermLUFS() const  { return shortTerm; }
+    float getIntegratedLUFS() const { return integrated; }
+
+    // Seconds of programme that have passed the absolute gate
+    float getGatedSeconds() const
+    {
+        juce::uint32 blocks = 0;
+        for (auto count : histogram)
+            blocks += count;
+        return (float) blocks * 0.1f;
+    }
+
+private:
+    static constexpr int shortTermSubBlocks = 30; // 3 s
+    static constexpr int momentarySubBlocks = 4;  // 400 ms
+    static constexpr float histogramStep = 0.1f;  // LU per bin
+    static constexpr int histogramBins = 751;     // -70 .. +5 LUFS
+
+    struct Biquad { float b0, b1, b2, a1, a2; };
+    struct FilterState { float s1 = 0.0f, s2 = 0.0f, t1 = 0.0f, t2 = 0.0f; };
+
+    static float lufsToEnergy(float lufs) { return std::pow(10.0f, (lufs + 0.691f) / 10.0f); }
+    static float energyToLufs(double energy) { return energy > 0.0 ? -0.691f + 10.0f * (float) std::log10(energy) : silenceLUFS; }
+
+    // Both K-weighting stages in transposed direct form II, returning the sum of squares
+    double filterAndSquare(FilterState& st, const float* samples, int numSamples) const
+    {
+        float s1 = st.s1, s2 = st.s2, t1 = st.t1, t2 = st.t2;
+        double sum = 0.0;
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            float x = samples[i];
+            float y = shelf.b0 * x + s1;
+            s1 = shelf.b1 * x - shelf.a1 * y + s2;
+            s2 = shelf.b2 * x - shelf.a2 * y;
+
+            float z = highPass.b0 * y + t1;
+            t1 = highPass.b1 * y - highPass.a1 * z + t2;
+            t2 = highPass.b2 * y - highPass.a2 * z;
+
+            sum += (double) (z * z);
+        }
+
+        st = { s1, s2, t1, t2 };
+        return sum;
+    }
+
+    void completeSubBlock(int numChannels)
+    {
+        // Channel weights are all 1.0 for the mono/stereo layouts the rack uses
+        double energy = 0.0;
+        for (int ch = 0; ch < numChannels; ++ch)
+        {
+            energy += subBlockSum[(size_t) ch] / (double) subBlockLength;
+            subBlockSum[(size_t) ch] = 0.0;
+        }
+        subBlockCount = 0;
+
+        subBlocks[(size_t) subBlockPos] = energy;
+        subBlockPos = (subBlockPos + 1) % shortTermSubBlocks;
+        numSubBlocks = juce::jmin(numSubBlocks + 1, shortTermSubBlocks);
+
+        auto windowEnergy = [this](int length) {
+            int available = juce::jmin(length, numSubBlocks);
+            double sum = 0.0;
+            for (int i = 1; i <= available; ++i)
+                sum += subBlocks[(size_t) ((subBlockPos - i + shortTermSubBlocks) % shortTermSubBlocks)];
+            return sum / (double) juce::jmax(1, available);
+        };
+
+        double momentaryEnergy = windowEnergy(momentarySubBlocks);
+        momentary = energyToLufs(momentaryEnergy);
+        shortTerm = energyToLufs(windowEnergy(shortTermSubBlocks));
+
+        // Each 100 ms step completes one 400 ms gating block (75% overlap)
+        if (numSubBlocks >= momentarySubBlocks && momentary > silenceLUFS)
+        {
+            int bin = juce::jlimit(0, histogramBins - 1, juce::roundToInt((momentary - silenceLUFS) / histogramStep));
+            ++histogram[(size_t) bin];
+            updateIntegrated();
+        }
+    }
+
+    void updateIntegrated()
+    {
+        auto gatedMean = [this](int firstBin) {
+            double sum = 0.0;
+            juce::uint64 count = 0;
+            for (int bin = firstBin; bin < histogramBins; ++bin)
+            {
+                sum += (double) histogram[(size_t) bin] * binEnergy[(size_t) bin];
+                count += histogram[(size_t) bin];
+            }
+            return count > 0 ? sum / (double) count : 0.0;
+        };
+
+        // Absolute gate is implicit (nothing below -70 LUFS is binned); relative gate is -10 LU
+        float relativeGate = energyToLufs(gatedMean(0)) - 10.0f;
+        int firstBin = juce::jlimit(0, histogramBins - 1, (int) std::ceil((relativeGate - silenceLUFS) / histogramStep));
+        integrated = energyToLufs(gatedMean(firstBin));
+    }
+
+    int channels = 2;
+    int subBlockLength = 4800;
+
+    Biquad shelf {}, highPass {};
+    std::array<FilterState, maxChannels> filterState {};
+
+    std::array<double, maxChannels> subBlockSum {};
+    int subBlockCount = 0;
+
+    std::array<double, shortTermSubBlocks> subBlocks {};
+    int subBlockPos = 0;
+    int numSubBlocks = 0;
+
+    std::array<juce::uint32, histogramBins> histogram {};
+    std::array<float, histogramBins> binEnergy {};
+
+    float momentary = silenceLUFS, shortTerm = silenceLUFS, integrated = silenceLUFS;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (LoudnessMeter)
+};
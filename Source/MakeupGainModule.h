@@ -0,0 +1,99 @@
+/*
+  ==============================================================================
+
+    MakeupGainModule.h
+    Automatic loudness makeup ahead of The Wall. "Match Input" holds the
+    processed signal at the input's short-term loudness, so A/B comparisons
+    need no gain-matching; "Target" steers the programme to a LUFS target
+    (integrated once enough has been heard, short-term before that).
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "LoudnessMeter.h"
+
+class MakeupGainModule
+{
+public:
+    enum class Mode { off, matchInput, target };
+
+    MakeupGainModule() {}
+    ~MakeupGainModule() {}
+
+    void prepare(const juce::dsp::ProcessSpec& spec)
+    {
+        inputMeter.prepare(spec.sampleRate, (int) spec.numChannels);
+        stageMeter.prepare(spec.sampleRate, (int) spec.numChannels);
+        smoothedGain.reset(spec.sampleRate, 0.3);
+        smoothedGain.setCurrentAndTargetValue(1.0f);
+        gainDb = 0.0f;
+    }
+
+    // Call on the untouched input, before any processing
+    void measureInput(const juce::AudioBuffer<float>& buffer)
+    {
+        if (mode == Mode::matchInput)
+            inputMeter.process(buffer);
+    }
+
+    void process(juce::AudioBuffer<float>& buffer)
+    {
+        if (! measure(buffer))
+            return;
+
+        for (int sample = 0; sample < buffer.getNumSamples(); ++sample)
+        {
+            float g = getNextGain();
+            for (int channel = 0; channel < buffer.getNumChannels(); ++channel)
+                buffer.getWritePointer(channel)[sample] *= g;
+        }
+    }
+
+    // process() in two halves, for callers that apply the gain themselves. measure() takes
+    // the block and sets the correction; false means the gain is unity for the whole block,
+    // otherwise take one getNextGain() per sample.
+    bool measure(const juce::AudioBuffer<float>& buffer)
+    {
+        // Measured before the gain is applied, so the correction never chases itself
+        stageMeter.process(buffer);
+
+        if (mode == Mode::off)
+        {
+            gainDb = 0.0f;
+        }
+        else
+        {
+            float reference = mode == Mode::matchInput ? inputMeter.getShortTermLUFS() : targetLUFS;
+            float measured = (mode == Mode::target && stageMeter.getGatedSeconds() >= 3.0f)
+                                 ? stageMeter.getIntegratedLUFS()
+                                 : stageMeter.getShortTermLUFS();
+
+            // Hold the last correction through silence instead of pumping up the noise floor
+            if (measured > LoudnessMeter::silenceLUFS + 10.0f && reference > LoudnessMeter::silenceLUFS + 10.0f)
+                gainDb = juce::jlimit(-maxGainDb, maxGainDb, reference - measured);
+        }
+
+        smoothedGain.setTargetValue(juce::Decibels::decibelsToGain(gainDb));
+        return smoothedGain.isSmoothing() || gainDb != 0.0f;
+    }
+
+    float getNextGain() { return smoothedGain.getNextValue(); }
+
+    float getGainDb() const { return gainDb; }
+    const LoudnessMeter& getStageMeter() const { return stageMeter; }
+
+    Mode mode = Mode::off;
+    float targetLUFS = -14.0f;
+
+private:
+    static constexpr float maxGainDb = 18.0f;
+
+    LoudnessMeter inputMeter, stageMeter;
+    juce::LinearSmoothedValue<float> smoothedGain { 1.0f };
+    float gainDb = 0.0f;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (MakeupGainModule)
+};
@@ -0,0 +1,146 @@
+/*
+  ==============================================================================
+
+    MeteringEngine.h
+    Output metering in one pass over each channel: sample peak, 4x
+    oversampled true peak (ITU-R BS.1770-4 interpolator) and a 300 ms
+    windowed RMS. Fixed cost per sample, no allocation after prepare().
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+class MeteringEngine
+{
+public:
+    static constexpr int maxChannels = 8;
+    static constexpr int oversampling = 4;
+    static constexpr int tapsPerPhase = 12;
+    static constexpr float rmsWindowSeconds = 0.3f;
+
+    MeteringEngine() {}
+    ~MeteringEngine() {}
+
+    void prepare(double sampleRate, int numChannels)
+    {
+        channels = juce::jlimit(1, maxChannels, numChannels);
+
+        // RMS window built from 10 ms segments, so the running sum is updated once per segment
+        segmentLength = juce::jmax(1, juce::roundToInt(sampleRate * 0.01));
+        numSegments = juce::jmax(1, juce::roundToInt(rmsWindowSeconds / 0.01f));
+
+        for (auto& c : state)
+            c.segments.assign((size_t) numSegments, 0.0);
+
+        reset();
+    }
+
+    void reset()
+    {
+        for (auto& c : state)
+        {
+            c.history.fill(0.0f);
+            c.historyPos = 0;
+            std::fill(c.segments.begin(), c.segments.end(), 0.0);
+            c.segmentPos = 0;
+            c.segmentCount = 0;
+            c.segmentSum = 0.0;
+            c.windowSum = 0.0;
+            c.peak = c.truePeak = c.rms = 0.0f;
+        }
+    }
+
+    // Measures the block; peaks are the maxima over this block only.
+    void process(const juce::AudioBuffer<float>& buffer)
+    {
+        const int numChannels = juce::jmin(channels, buffer.getNumChannels());
+        const int numSamples = buffer.getNumSamples();
+
+        for (int ch = 0; ch < numChannels; ++ch)
+            processChannel(state[(size_t) ch], buffer.getReadPointer(ch), numSamples);
+    }
+
+    int getNumChannels() const          { return channels; }
+    float getPeak(int channel) const     { return state[(size_t) channel].peak; }
+    float getTruePeak(int channel) const { return state[(size_t) channel].truePeak; }
+    float getRMS(int channel) const      { return state[(size_t) channel].rms; }
+
+private:
+    struct ChannelState
+    {
+        // Interpolator input, mirrored so the newest tapsPerPhase samples are always contiguous
+        std::array<float, tapsPerPhase * 2> history {};
+        int historyPos = 0;
+
+        std::vector<double> segments;
+        int segmentPos = 0;
+        int segmentCount = 0;
+        double segmentSum = 0.0;
+        double windowSum = 0.0;
+
+        float peak = 0.0f, truePeak = 0.0f, rms = 0.0f;
+    };
+
+    void processChannel(ChannelState& c, const float* samples, int numSamples)
+    {
+        float peak = 0.0f, truePeak = 0.0f;
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            const float x = samples[i];
+            peak = juce::jmax(peak, std::abs(x));
+
+            c.history[(size_t) c.historyPos] = x;
+            c.history[(size_t) (c.historyPos + tapsPerPhase)] = x;
+            c.historyPos = (c.historyPos + 1) % tapsPerPhase;
+
+            // Four interpolation phases over the same twelve taps; flat loops so they vectorise
+            const float* taps = c.history.data() + c.historyPos;
+            std::array<float, oversampling> phaseOut {};
+            for (int k = 0; k < tapsPerPhase; ++k)
+                for (int p = 0; p < oversampling; ++p)
+                    phaseOut[(size_t) p] += coefficients[(size_t) p][(size_t) k] * taps[k];
+
+            for (int p = 0; p < oversampling; ++p)
+                truePeak = juce::jmax(truePeak, std::abs(phaseOut[(size_t) p]));
+
+            c.segmentSum += (double) (x * x);
+            if (++c.segmentCount == segmentLength)
+            {
+                c.windowSum += c.segmentSum - c.segments[(size_t) c.segmentPos];
+                c.segments[(size_t) c.segmentPos] = c.segmentSum;
+                c.segmentPos = (c.segmentPos + 1) % numSegments;
+                c.segmentSum = 0.0;
+                c.segmentCount = 0;
+            }
+        }
+
+        c.peak = peak;
+        c.truePeak = juce::jmax(peak, truePeak);
+        c.rms = (float) std::sqrt(juce::jmax(0.0, c.windowSum) / (double) (segmentLength * numSegments));
+    }
+
+    // ITU-R BS.1770-4 Annex 2 polyphase interpolator, taps ordered oldest sample first
+    static constexpr float coefficients[oversampling][tapsPerPhase] =
+    {
+        { -0.0083007812500f,  0.0148925781250f, -0.0266113281250f,  0.0476074218750f, -0.1022949218750f,  0.9721679687500f,
+           0.1373291015625f, -0.0594482421875f,  0.0332031250000f, -0.0196533203125f,  0.0109863281250f,  0.0017089843750f },
+        { -0.0189208984375f,  0.0330810546875f, -0.0582275390625f,  0.1015625000000f, -0.2003173828125f,  0.7797851562500f,
+           0.4650878906250f, -0.1665039062500f,  0.0891113281250f, -0.0517578125000f,  0.0292968750000f, -0.0291748046875f },
+        { -0.0291748046875f,  0.0292968750000f, -0.0517578125000f,  0.0891113281250f, -0.1665039062500f,  0.4650878906250f,
+           0.7797851562500f, -0.2003173828125f,  0.1015625000000f, -0.0582275390625f,  0.0330810546875f, -0.0189208984375f },
+        {  0.0017089843750f,  0.0109863281250f, -0.0196533203125f,  0.0332031250000f, -0.0594482421875f,  0.1373291015625f,
+           0.9721679687500f, -0.1022949218750f,  0.0476074218750f, -0.0266113281250f,  0.0148925781250f, -0.0083007812500f }
+    };
+
+    int channels = 2;
+    int segmentLength = 480;
+    int numSegments = 30;
+
+    std::array<ChannelState, maxChannels> state;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (MeteringEngine)
+};
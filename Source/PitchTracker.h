@@ -0,0 +1,327 @@
+/*
+  ==============================================================================
+
+    PitchTracker.h
+    Low-latency YIN pitch and voicing tracker for the Pressure Detector.
+    Runs at a decimated rate with an FFT autocorrelation, at most one
+    analysis per block, so its per-block cost is bounded. In real time the
+    analysis runs on the shared worker pool and is collected next block;
+    a missed deadline keeps the previous estimate.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "RealtimeWorkerPool.h"
+
+class PitchTracker
+{
+public:
+    static constexpr float targetRate   = 11025.0f; // Decimated analysis rate
+    static constexpr int   fftOrder     = 10;       // Linear correlation of frame x window
+    static constexpr int   frameSize    = 512;      // Decimated samples per analysis frame
+    static constexpr int   windowSize   = 256;      // YIN integration window
+    static constexpr int   hopSize      = 128;      // Decimated samples between analyses
+    static constexpr float minFrequency = 60.0f;
+    static constexpr float maxFrequency = 1500.0f;
+    static constexpr float yinThreshold = 0.15f;
+    static constexpr float voicedConfidence = 0.7f;
+
+    PitchTracker() {}
+    ~PitchTracker() { waitForAnalysis(); }
+
+    void prepare(double sampleRate)
+    {
+        waitForAnalysis();
+        rate = sampleRate;
+
+        decimation = juce::jmax(1, juce::roundToInt(sampleRate / targetRate));
+        analysis.decimatedRate = (float) (sampleRate / decimation);
+
+        analysis.tauMin = juce::jmax(2, (int) (analysis.decimatedRate / maxFrequency));
+        analysis.tauMax = juce::jmin(frameSize - windowSize, (int) (analysis.decimatedRate / minFrequency));
+
+        // 4th-order Butterworth anti-alias filter ahead of the decimator
+        juce::dsp::ProcessSpec monoSpec { sampleRate, 1, 1 };
+        float cutoff = analysis.decimatedRate * 0.45f;
+        antiAlias[0].prepare(monoSpec);
+        antiAlias[1].prepare(monoSpec);
+        *antiAlias[0].coefficients = *juce::dsp::IIR::Coefficients<float>::makeLowPass(sampleRate, cutoff, 0.5412f);
+        *antiAlias[1].coefficients = *juce::dsp::IIR::Coefficients<float>::makeLowPass(sampleRate, cutoff, 1.3066f);
+
+        const int fftSize = 1 << fftOrder;
+        if (analysis.fft == nullptr)
+            analysis.fft = std::make_unique<juce::dsp::FFT>(fftOrder);
+        analysis.frameSpectrum.assign((size_t) fftSize * 2, 0.0f);
+        analysis.windowSpectrum.assign((size_t) fftSize * 2, 0.0f);
+
+        analysis.frameData.assign((size_t) frameSize, 0.0f);
+        ring.assign((size_t) frameSize, 0.0f);
+        analysis.energyPrefix.assign((size_t) frameSize + 1, 0.0f);
+        analysis.cmndf.assign((size_t) analysis.tauMax + 2, 1.0f);
+
+        reset();
+    }
+
+    void reset()
+    {
+        waitForAnalysis();
+        analysis.markCollected();
+        analysisLate = false;
+
+        for (auto& f : antiAlias)
+            f.reset();
+
+        std::fill(ring.begin(), ring.end(), 0.0f);
+        ringPos = 0;
+        decimationCounter = 0;
+        decimationSum = 0.0f;
+        samplesSinceAnalysis = 0;
+
+        pitchHz = 0.0f;
+        confidence = 0.0f;
+        voiced = false;
+        missedDeadlines = 0;
+    }
+
+    // Off for offline renders, so bounces are deterministic. The first call with true
+    // joins the shared pool, starting its workers if it's the first, so make that one
+    // off the audio thread; trackers that never ask never start it.
+    void setUseWorkerPool(bool shouldUse)
+    {
+        if (shouldUse && workerPool == nullptr)
+            workerPool = std::make_unique<juce::SharedResourcePointer<RealtimeWorkerPool>>();
+
+        useWorkerPool = shouldUse && (*workerPool)->isAvailable();
+    }
+
+    void process(const float* samples, int numSamples)
+    {
+        collectAnalysis();
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            float x = antiAlias[1].processSample(antiAlias[0].processSample(samples[i]));
+            decimationSum += x;
+
+            if (++decimationCounter == decimation)
+            {
+                ring[(size_t) ringPos] = decimationSum / (float) decimation;
+                ringPos = (ringPos + 1) % frameSize;
+                decimationCounter = 0;
+                decimationSum = 0.0f;
+                ++samplesSinceAnalysis;
+            }
+        }
+
+        // Only the newest frame is analysed, however large the block is. While a
+        // previous analysis is still in flight the hop simply waits for it.
+        if (samplesSinceAnalysis >= hopSize && ! analysis.isInFlight())
+        {
+            samplesSinceAnalysis = 0;
+
+            // Oldest sample first
+            int tail = frameSize - ringPos;
+            std::copy(ring.begin() + ringPos, ring.end(), analysis.frameData.begin());
+            std::copy(ring.begin(), ring.begin() + ringPos, analysis.frameData.begin() + tail);
+
+            // Due before the next block starts, which is when it is collected
+            auto deadline = RealtimeWorkerPool::deadlineAfterSeconds((double) numSamples / rate);
+
+            if (! (useWorkerPool && (*workerPool)->submit(analysis, deadline)))
+            {
+                analysis.analyse();
+                applyResult();
+            }
+        }
+    }
+
+    float getPitchHz() const      { return pitchHz; }    // Last voiced estimate, 0 before the first
+    float getConfidence() const   { return confidence; } // 0..1, 1 - the YIN aperiodicity
+    bool isVoiced() const         { return voiced; }
+
+    int getLatencySamples() const { return frameSize * decimation; }
+
+    // Worker analyses that missed their deadline; the previous estimate was held each time
+    int getMissedDeadlines() const { return missedDeadlines; }
+
+private:
+    //==============================================================================
+    // One YIN analysis of frameData. Runs on a pool worker or inline, never both at once.
+    struct Analysis : public RealtimeJob
+    {
+        void run() override { analyse(); }
+
+        void analyse()
+        {
+            energyPrefix[0] = 0.0f;
+            for (int i = 0; i < frameSize; ++i)
+                energyPrefix[(size_t) i + 1] = energyPrefix[(size_t) i] + frameData[(size_t) i] * frameData[(size_t) i];
+
+            float windowEnergy = energyPrefix[(size_t) windowSize];
+            if (windowEnergy < 1.0e-6f)
+            {
+                resultConfidence = 0.0f;
+                resultVoiced = false;
+                return;
+            }
+
+            // r(tau) = sum_j x[j] * x[j + tau] for j < windowSize, as one FFT cross-correlation
+            std::fill(frameSpectrum.begin(), frameSpectrum.end(), 0.0f);
+            std::fill(windowSpectrum.begin(), windowSpectrum.end(), 0.0f);
+            std::copy(frameData.begin(), frameData.end(), frameSpectrum.begin());
+            std::copy(frameData.begin(), frameData.begin() + windowSize, windowSpectrum.begin());
+
+            fft->performRealOnlyForwardTransform(frameSpectrum.data(), true);
+            fft->performRealOnlyForwardTransform(windowSpectrum.data(), true);
+
+            const int numBins = (1 << fftOrder) / 2 + 1;
+            for (int bin = 0; bin < numBins; ++bin)
+            {
+                auto* a = frameSpectrum.data() + bin * 2;
+                auto* b = windowSpectrum.data() + bin * 2;
+                float re = a[0] * b[0] + a[1] * b[1];
+                float im = a[1] * b[0] - a[0] * b[1];
+                a[0] = re;
+                a[1] = im;
+            }
+
+            fft->performRealOnlyInverseTransform(frameSpectrum.data());
+            const auto& correlation = frameSpectrum;
+
+            // Normalise against r(0), which must equal the window energy, so the
+            // result does not depend on the FFT's inverse scaling convention
+            if (correlation[0] <= 0.0f)
+            {
+                resultConfidence = 0.0f;
+                resultVoiced = false;
+                return;
+            }
+
+            float scale = windowEnergy / correlation[0];
+
+            // Cumulative mean normalised difference function
+            cmndf[0] = 1.0f;
+            float runningSum = 0.0f;
+            for (int tau = 1; tau <= tauMax; ++tau)
+            {
+                float shiftedEnergy = energyPrefix[(size_t) (tau + windowSize)] - energyPrefix[(size_t) tau];
+                float difference = juce::jmax(0.0f, windowEnergy + shiftedEnergy - 2.0f * correlation[(size_t) tau] * scale);
+                runningSum += difference;
+                cmndf[(size_t) tau] = runningSum > 0.0f ? difference * (float) tau / runningSum : 1.0f;
+            }
+
+            // First dip under the threshold, walked down to its minimum; else the global minimum
+            int bestTau = -1;
+            for (int tau = tauMin; tau <= tauMax; ++tau)
+            {
+                if (cmndf[(size_t) tau] < yinThreshold)
+                {
+                    while (tau + 1 <= tauMax && cmndf[(size_t) tau + 1] < cmndf[(size_t) tau])
+                        ++tau;
+                    bestTau = tau;
+                    break;
+                }
+            }
+
+            if (bestTau < 0)
+            {
+                bestTau = tauMin;
+                for (int tau = tauMin + 1; tau <= tauMax; ++tau)
+                    if (cmndf[(size_t) tau] < cmndf[(size_t) bestTau])
+                        bestTau = tau;
+            }
+
+            // Parabolic interpolation around the chosen lag
+            float refinedTau = (float) bestTau;
+            if (bestTau > tauMin && bestTau < tauMax)
+            {
+                float s0 = cmndf[(size_t) bestTau - 1], s1 = cmndf[(size_t) bestTau], s2 = cmndf[(size_t) bestTau + 1];
+                float denom = s0 - 2.0f * s1 + s2;
+                if (std::abs(denom) > 1.0e-9f)
+                    refinedTau += juce::jlimit(-0.5f, 0.5f, 0.5f * (s0 - s2) / denom);
+            }
+
+            resultConfidence = juce::jlimit(0.0f, 1.0f, 1.0f - cmndf[(size_t) bestTau]);
+            resultVoiced = resultConfidence >= voicedConfidence;
+            resultPitchHz = resultVoiced ? decimatedRate / refinedTau : 0.0f;
+        }
+
+        float decimatedRate = targetRate;
+        int tauMin = 2, tauMax = 256;
+
+        std::unique_ptr<juce::dsp::FFT> fft;
+        std::vector<float> frameSpectrum, windowSpectrum;
+        std::vector<float> frameData, energyPrefix, cmndf;
+
+        float resultPitchHz = 0.0f;
+        float resultConfidence = 0.0f;
+        bool resultVoiced = false;
+    };
+
+    void applyResult()
+    {
+        confidence = analysis.resultConfidence;
+        voiced = analysis.resultVoiced;
+
+        if (voiced)
+            pitchHz = analysis.resultPitchHz;
+    }
+
+    // Picks up last block's worker result. Until it arrives the previous estimate stands;
+    // a result that was skipped for lateness is simply dropped.
+    void collectAnalysis()
+    {
+        auto state = analysis.getState();
+        if (state == RealtimeJob::idle)
+            return;
+
+        if (state != RealtimeJob::finished && ! analysisLate)
+        {
+            ++missedDeadlines;
+            analysisLate = true;
+        }
+
+        if (state == RealtimeJob::finished)
+            applyResult();
+
+        if (state == RealtimeJob::finished || state == RealtimeJob::expired)
+        {
+            analysis.markCollected();
+            analysisLate = false;
+        }
+    }
+
+    void waitForAnalysis()
+    {
+        while (analysis.isInFlight())
+            juce::Thread::yield();
+    }
+
+    double rate = 44100.0;
+    int decimation = 4;
+
+    juce::dsp::IIR::Filter<float> antiAlias[2];
+
+    std::unique_ptr<juce::SharedResourcePointer<RealtimeWorkerPool>> workerPool;
+    bool useWorkerPool = false;
+
+    Analysis analysis;
+    bool analysisLate = false;
+    int missedDeadlines = 0;
+
+    std::vector<float> ring;
+
+    int ringPos = 0;
+    int decimationCounter = 0;
+    float decimationSum = 0.0f;
+    int samplesSinceAnalysis = 0;
+
+    float pitchHz = 0.0f;
+    float confidence = 0.0f;
+    bool voiced = false;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (PitchTracker)
+};
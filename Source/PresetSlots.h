@@ -0,0 +1,102 @@
+/*
+  ==============================================================================
+
+    PresetSlots.h
+    A/B preset slots holding RackSettings. Slots are filled on the message
+    thread and handed to the audio thread through a double buffer per slot:
+    the writer fills the buffer the reader isn't using and publishes it with
+    one atomic store. The audio thread never waits and never allocates; the
+    writer may briefly wait for a copy in progress. BinaryStateCodec saves
+    the stored slots with the plugin state.
+
+    Only the scalar settings are swapped. The modules' derived state (EQ
+    coefficients, reverb parameters) also follows the live detector, so it
+    can't be prepared per slot; a switch or morph moves the stages' inputs
+    and each DerivedState rebuilds on the audio thread once they have moved
+    far enough, as for any parameter change.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "RackSettings.h"
+
+class PresetSlots
+{
+public:
+    enum Slot { slotA = 0, slotB, numSlots };
+
+    PresetSlots() {}
+    ~PresetSlots() {}
+
+    // Message thread
+    void store(Slot slot, const RackSettings& settings)
+    {
+        auto& h = handoffs[(size_t) slot];
+
+        const int target = 1 - h.published.load(std::memory_order_acquire);
+        while (h.reading.load(std::memory_order_seq_cst) == target)
+            juce::Thread::yield();
+
+        h.buffers[(size_t) target] = settings;
+        h.published.store(target, std::memory_order_seq_cst);
+        h.stored.store(true, std::memory_order_release);
+        h.version.fetch_add(1, std::memory_order_release);
+
+        latest[(size_t) slot] = settings;
+    }
+
+    // Message thread, e.g. when a saved state has nothing in this slot
+    void clear(Slot slot)
+    {
+        handoffs[(size_t) slot].stored.store(false, std::memory_order_release);
+        latest[(size_t) slot] = {};
+    }
+
+    bool isStored(Slot slot) const { return handoffs[(size_t) slot].stored.load(std::memory_order_acquire); }
+
+    // Message thread: the settings last stored in a slot
+    const RackSettings& getStored(Slot slot) const { return latest[(size_t) slot]; }
+
+    // Audio thread: copies any slot that changed since the last call into dest
+    void pull(std::array<RackSettings, numSlots>& dest)
+    {
+        for (size_t i = 0; i < handoffs.size(); ++i)
+        {
+            auto& h = handoffs[i];
+            auto version = h.version.load(std::memory_order_acquire);
+            if (version == pulledVersions[i])
+                continue;
+
+            // Claim the published buffer, re-checking in case the writer flipped meanwhile
+            int index;
+            do
+            {
+                index = h.published.load(std::memory_order_acquire);
+                h.reading.store(index, std::memory_order_seq_cst);
+            } while (index != h.published.load(std::memory_order_seq_cst));
+
+            dest[i] = h.buffers[(size_t) index];
+            h.reading.store(-1, std::memory_order_release);
+            pulledVersions[i] = version;
+        }
+    }
+
+private:
+    struct Handoff
+    {
+        std::array<RackSettings, 2> buffers;
+        std::atomic<int> published { 0 };
+        std::atomic<int> reading { -1 };
+        std::atomic<juce::uint32> version { 0 };
+        std::atomic<bool> stored { false };
+    };
+
+    std::array<Handoff, numSlots> handoffs;
+    std::array<RackSettings, numSlots> latest; // The message thread's own copies
+    std::array<juce::uint32, numSlots> pulledVersions {};
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (PresetSlots)
+};
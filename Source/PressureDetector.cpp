@@ -25,25 +25,29 @@ void PressureDetector::prepare(const juce::dsp::ProcessSpec& spec)
     juce::dsp::ProcessSpec monoSpec = spec;
     monoSpec.numChannels = 1;
 
-    lowFilter.prepare(monoSpec);
-    midFilter.prepare(monoSpec);
-    highFilter.prepare(monoSpec);
+    bandSplitter.prepare(monoSpec);
+    spectralAnalyser.prepare(sampleRate, (int) spec.maximumBlockSize);
+    pitchTracker.prepare(sampleRate);
+    transientDetector.prepare(sampleRate, (int) spec.maximumBlockSize);
 
-    // Low band for "Density" (Fundamental weight ~100-400Hz)
-    *lowFilter.coefficients = *juce::dsp::IIR::Coefficients<float>::makeLowPass(sampleRate, 350.0f);
+    smoothedIntensity.reset(sampleRate, intensitySmoothingSeconds);
+    smoothedDensity.reset(sampleRate, shapeSmoothingSeconds);
+    smoothedTimbre.reset(sampleRate, shapeSmoothingSeconds);
 
-    // Mid band for "Timbre" analysis (Harshness/Presence ~2.5kHz-5kHz)
-    *midFilter.coefficients = *juce::dsp::IIR::Coefficients<float>::makeBandPass(sampleRate, 3500.0f, 0.4f);
-
-    // High band for "Harshness/Air" (>6kHz)
-    *highFilter.coefficients = *juce::dsp::IIR::Coefficients<float>::makeHighPass(sampleRate, 7000.0f);
+    maxBlockSize = (int) spec.maximumBlockSize;
+    historyHead = historyCount = 0;
+}
 
-    smoothedIntensity.reset(sampleRate, 0.05);
-    smoothedDensity.reset(sampleRate, 0.1);
-    smoothedTimbre.reset(sampleRate, 0.1);
+size_t PressureDetector::getScratchSize(const juce::dsp::ProcessSpec& spec)
+{
+    return (size_t) spec.maximumBlockSize + BandSplitter::getScratchSize(1, (int) spec.maximumBlockSize);
+}
 
-    monoBuffer.setSize(1, spec.maximumBlockSize);
-    analysisBuffer.setSize(1, spec.maximumBlockSize);
+void PressureDetector::setScratch(float* memory)
+{
+    monoChannel = memory;
+    monoBuffer.setDataToReferTo(&monoChannel, 1, maxBlockSize);
+    bandSplitter.setScratch(memory + maxBlockSize);
 }
 
 void PressureDetector::process(const juce::AudioBuffer<float>& buffer, const juce::AudioBuffer<float>* sidechain)
@@ -51,29 +55,22 @@ void PressureDetector::process(const juce::AudioBuffer<float>& buffer, const juc
     int numSamples = buffer.getNumSamples();
     if (numSamples == 0) return;
 
-    // Use sidechain for analysis if available, otherwise use input buffer
-    const juce::AudioBuffer<float>& analysisSource = (sidechain != nullptr && sidechain->getNumSamples() >= numSamples) ? *sidechain : buffer;
+    pitchFromSnapshot = transientHeld = false;
+    const auto& analysisSource = foldToMono(buffer, sidechain);
 
     // 1. Intensity: Overall RMS
     float rawIntensity = analysisSource.getRMSLevel(0, 0, numSamples);
     smoothedIntensity.setTargetValue(juce::jlimit(0.0f, 1.0f, rawIntensity * 2.0f)); // Normalized/boosted
     intensity = smoothedIntensity.getNextValue();
 
-    // Use pre-allocated monoBuffer for spectral analysis
-    monoBuffer.copyFrom(0, 0, analysisSource, 0, 0, numSamples);
-    if (analysisSource.getNumChannels() > 1) {
-        monoBuffer.addFrom(0, 0, analysisSource, 1, 0, numSamples);
-        monoBuffer.applyGain(0.5f);
-    }
+    // Split once; density and timbre both read their band energies from it
+    bandSplitter.process(monoBuffer, 1, numSamples);
+    spectralAnalyser.process(monoBuffer.getReadPointer(0), numSamples);
+    pitchTracker.process(monoBuffer.getReadPointer(0), numSamples);
+    transientDetector.process(monoBuffer.getReadPointer(0), numSamples);
 
     // 2. Density: Low energy vs mid/high energy
-    analysisBuffer.copyFrom(0, 0, monoBuffer, 0, 0, numSamples);
-
-    juce::dsp::AudioBlock<float> block(analysisBuffer);
-    juce::dsp::ProcessContextReplacing<float> context(block);
-    lowFilter.process(context);
-
-    float lowRMS = analysisBuffer.getRMSLevel(0, 0, numSamples);
+    float lowRMS = bandSplitter.getBandRMS(BandSplitter::low);
     float totalRMS = monoBuffer.getRMSLevel(0, 0, numSamples) + 0.0001f;
 
     // Density is the ratio of low-frequency energy to total energy
@@ -81,19 +78,171 @@ void PressureDetector::process(const juce::AudioBuffer<float>& buffer, const juc
     density = smoothedDensity.getNextValue();
 
     // 3. Timbre: High-mid harshness
-    analysisBuffer.copyFrom(0, 0, monoBuffer, 0, 0, numSamples);
+    float presenceRMS = bandSplitter.getBandRMS(BandSplitter::presence);
+
+    // Timbre here represents the presence of harsh resonant energy in the mids.
+    // A peaky (low flatness) spectrum reads as more resonant than a noisy one: the
+    // ratio is scaled by 0.6 (pure noise) to 1.2 (pure tone), using every frame of the
+    // block. This moves timbre away from the plain band ratio it used to be, so a
+    // tonal vocal reads harsher and a breathy one softer than before.
+    float rawTimbre = presenceRMS / (totalRMS * 0.5f);
+    if (spectralAnalyser.hasFrame())
+    {
+        const int numFrames = spectralAnalyser.getNumFramesThisBlock();
+        float flatness = spectralAnalyser.getFrame().flatness;
+        if (numFrames > 0)
+        {
+            flatness = 0.0f;
+            for (int f = 0; f < numFrames; ++f)
+                flatness += spectralAnalyser.getFrame(f).flatness;
+            flatness /= (float) numFrames;
+        }
+
+        rawTimbre *= 0.6f + 0.6f * (1.0f - flatness);
+    }
+
+    smoothedTimbre.setTargetValue(juce::jlimit(0.0f, 1.0f, rawTimbre));
+    timbre = smoothedTimbre.getNextValue();
 
-    juce::dsp::AudioBlock<float> midBlock(analysisBuffer);
-    juce::dsp::ProcessContextReplacing<float> midContext(midBlock);
-    midFilter.process(midContext);
+    pushHistory(numSamples);
+}
+
+void PressureDetector::processLinked(const juce::AudioBuffer<float>& buffer, const juce::AudioBuffer<float>* sidechain,
+                                     float linkedIntensity, float linkedDensity, float linkedTimbre)
+{
+    int numSamples = buffer.getNumSamples();
+    if (numSamples == 0) return;
 
-    float midRMS = analysisBuffer.getRMSLevel(0, 0, numSamples);
+    // The band split and STFT only feed density and timbre, so they stay idle
+    pitchFromSnapshot = transientHeld = false;
+    foldToMono(buffer, sidechain);
+    pitchTracker.process(monoBuffer.getReadPointer(0), numSamples);
+    transientDetector.process(monoBuffer.getReadPointer(0), numSamples);
 
-    // Timbre here represents the presence of harsh resonant energy in the mids
-    smoothedTimbre.setTargetValue(juce::jlimit(0.0f, 1.0f, midRMS / (totalRMS * 0.5f)));
-    timbre = smoothedTimbre.getNextValue();
+    intensity = linkedIntensity;
+    density = linkedDensity;
+    timbre = linkedTimbre;
+
+    smoothedIntensity.setCurrentAndTargetValue(intensity);
+    smoothedDensity.setCurrentAndTargetValue(density);
+    smoothedTimbre.setCurrentAndTargetValue(timbre);
+
+    pushHistory(numSamples);
+}
+
+PressureDetector::Snapshot PressureDetector::getUnsmoothedSnapshot() const
+{
+    Snapshot snapshot;
+    snapshot.intensity = smoothedIntensity.getTargetValue();
+    snapshot.density = smoothedDensity.getTargetValue();
+    snapshot.timbre = smoothedTimbre.getTargetValue();
+    snapshot.pitchHz = getPitchHz();
+    snapshot.pitchConfidence = getPitchConfidence();
+    return snapshot;
+}
+
+PressureDetector::Snapshot PressureDetector::getSnapshot() const
+{
+    Snapshot snapshot;
+    snapshot.intensity = intensity;
+    snapshot.density = density;
+    snapshot.timbre = timbre;
+    snapshot.pitchHz = getPitchHz();
+    snapshot.pitchConfidence = getPitchConfidence();
+    return snapshot;
+}
+
+void PressureDetector::processFromSnapshot(const juce::AudioBuffer<float>& buffer, const Snapshot& snapshot)
+{
+    int numSamples = buffer.getNumSamples();
+    if (numSamples == 0) return;
+
+    transientHeld = false;
+    foldToMono(buffer, nullptr);
+    transientDetector.process(monoBuffer.getReadPointer(0), numSamples);
+
+    intensity = snapshot.intensity;
+    density = snapshot.density;
+    timbre = snapshot.timbre;
+
+    smoothedIntensity.setCurrentAndTargetValue(intensity);
+    smoothedDensity.setCurrentAndTargetValue(density);
+    smoothedTimbre.setCurrentAndTargetValue(timbre);
+
+    pitchFromSnapshot = true;
+    snapshotPitchHz = snapshot.pitchHz;
+    snapshotConfidence = snapshot.pitchConfidence;
+
+    pushHistory(numSamples);
+}
+
+void PressureDetector::pushHistory(int numSamples)
+{
+    auto& entry = history[(size_t) historyHead];
+    entry.values.intensity = intensity;
+    entry.values.density = density;
+    entry.values.timbre = timbre;
+    entry.values.pitchHz = getPitchHz();
+    entry.values.pitchConfidence = getPitchConfidence();
+    entry.transientStrength = getTransientStrength();
+    entry.numSamples = numSamples;
+
+    historyHead = (historyHead + 1) % historySize;
+    historyCount = juce::jmin(historyCount + 1, historySize);
+}
+
+void PressureDetector::followDelayed(const PressureDetector& source, int delaySamples)
+{
+    if (source.historyCount == 0)
+        return;
+
+    // The block that held the sample delaySamples before the middle of source's latest block
+    const HistoryEntry* entry = nullptr;
+    int samplesBack = 0, target = 0;
+    for (int i = 0; i < source.historyCount; ++i)
+    {
+        entry = &source.history[(size_t) ((source.historyHead - 1 - i + historySize) % historySize)];
+        if (i == 0)
+            target = entry->numSamples / 2 + delaySamples;
+
+        samplesBack += entry->numSamples;
+        if (samplesBack > target)
+            break;
+    }
+
+    intensity = entry->values.intensity;
+    density = entry->values.density;
+    timbre = entry->values.timbre;
+
+    pitchFromSnapshot = true;
+    snapshotPitchHz = entry->values.pitchHz;
+    snapshotConfidence = entry->values.pitchConfidence;
+
+    transientHeld = true;
+    heldTransient = entry->transientStrength;
+}
+
+// Picks the sidechain if it is connected, otherwise the input, and folds it into monoBuffer.
+// Returns the picked source.
+const juce::AudioBuffer<float>& PressureDetector::foldToMono(const juce::AudioBuffer<float>& buffer, const juce::AudioBuffer<float>* sidechain)
+{
+    int numSamples = buffer.getNumSamples();
+    const juce::AudioBuffer<float>& analysisSource = (sidechain != nullptr && sidechain->getNumChannels() > 0 && sidechain->getNumSamples() >= numSamples) ? *sidechain : buffer;
+
+    // Use pre-allocated monoBuffer for spectral analysis
+    monoBuffer.copyFrom(0, 0, analysisSource, 0, 0, numSamples);
+    if (analysisSource.getNumChannels() > 1) {
+        monoBuffer.addFrom(0, 0, analysisSource, 1, 0, numSamples);
+        monoBuffer.applyGain(0.5f);
+    }
+
+    return analysisSource;
 }
 
 float PressureDetector::getIntensity() const { return intensity; }
 float PressureDetector::getDensity() const   { return density; }
 float PressureDetector::getTimbre() const    { return timbre; }
+
+float PressureDetector::getPitchHz() const         { return pitchFromSnapshot ? snapshotPitchHz : pitchTracker.getPitchHz(); }
+float PressureDetector::getPitchConfidence() const { return pitchFromSnapshot ? snapshotConfidence : pitchTracker.getConfidence(); }
+bool PressureDetector::isVoiced() const            { return pitchFromSnapshot ? snapshotConfidence >= PitchTracker::voicedConfidence : pitchTracker.isVoiced(); }
@@ -11,6 +11,10 @@
 #pragma once
 
 #include <JuceHeader.h>
+#include "BandSplitter.h"
+#include "SpectralAnalyser.h"
+#include "PitchTracker.h"
+#include "TransientDetector.h"
 
 class PressureDetector
 {
@@ -21,28 +25,122 @@ public:
     void prepare(const juce::dsp::ProcessSpec& spec);
     void process(const juce::AudioBuffer<float>& buffer, const juce::AudioBuffer<float>* sidechain = nullptr);
 
+    // Follows intensity, density and timbre from elsewhere (a PressureLink) instead of
+    // analysing them; pitch and transients still come from this signal. Local analysis
+    // resumes from the followed values.
+    void processLinked(const juce::AudioBuffer<float>& buffer, const juce::AudioBuffer<float>* sidechain,
+                       float linkedIntensity, float linkedDensity, float linkedTimbre);
+
+    // One block of the detector's block-rate outputs, as a PressureTrajectory stores them
+    struct Snapshot
+    {
+        float intensity = 0.0f, density = 0.0f, timbre = 0.0f;
+        float pitchHz = 0.0f, pitchConfidence = 0.0f;
+    };
+
+    // This block's measurements before smoothing, with the current pitch estimate
+    Snapshot getUnsmoothedSnapshot() const;
+
+    // This block's outputs as the chain reads them, smoothed, with the current pitch estimate
+    Snapshot getSnapshot() const;
+
+    // Takes pressure and pitch from a precomputed snapshot instead of analysing them;
+    // only the transient lane runs on this signal
+    void processFromSnapshot(const juce::AudioBuffer<float>& buffer, const Snapshot& snapshot);
+
+    // Makes this detector report the block-rate outputs that source reported delaySamples
+    // earlier, for stages that hear the audio late by a spectral stage's latency. Nothing
+    // is analysed and there is no transient lane. Block-accurate, as far back as source's
+    // last historySize blocks reach.
+    void followDelayed(const PressureDetector& source, int delaySamples);
+    static constexpr int historySize = 128;
+
+    // How far the pitch estimate trails the signal
+    int getPitchLatencySamples() const { return pitchTracker.getLatencySamples(); }
+
+    // Ramp lengths of the intensity and the density/timbre smoothing. They advance one
+    // step per block, so a ramp takes seconds * sampleRate blocks.
+    static constexpr double intensitySmoothingSeconds = 0.05;
+    static constexpr double shapeSmoothingSeconds = 0.1;
+
     float getIntensity() const;
     float getDensity() const;
     float getTimbre() const;
 
+    // Sung pitch. Hold the last voiced estimate; weight any use by the confidence.
+    float getPitchHz() const;
+    float getPitchConfidence() const;
+    bool isVoiced() const;
+
+    // Run the pitch analysis on the shared worker pool, collected one block later
+    void setUseWorkerPool(bool shouldUse) { pitchTracker.setUseWorkerPool(shouldUse); }
+
+    // Transient lane: per-sample attack strength (0..1) for the current block, plus onset positions
+    const float* getTransientLane() const { return transientDetector.getLane(); }
+    float getTransientStrength() const { return transientHeld ? heldTransient : transientDetector.getBlockPeak(); }
+    int getNumOnsets() const { return transientDetector.getNumOnsets(); }
+    int getOnsetPosition(int index) const { return transientDetector.getOnsetPosition(index); }
+
+    // Mono analysis signal and its band split live in the owner's ScratchArena. They are
+    // only read inside process(), so the memory is free again once it returns.
+    static size_t getScratchSize(const juce::dsp::ProcessSpec& spec);
+    void setScratch(float* memory);
+
+    // STFT analysis frames, read in place. getSpectralFrame() is the latest, possibly from
+    // an earlier block; getSpectralFrame(i) is the i-th of this block's frames, oldest first.
+    const SpectralFrame& getSpectralFrame() const { return spectralAnalyser.getFrame(); }
+    const SpectralFrame& getSpectralFrame(int indexThisBlock) const { return spectralAnalyser.getFrame(indexThisBlock); }
+    int getNumSpectralFramesThisBlock() const { return spectralAnalyser.getNumFramesThisBlock(); }
+
+    // Analysis hop in samples; applied on the next prepare()
+    void setAnalysisHop(int hopSamples) { spectralAnalyser.setHopSize(hopSamples); }
+
 private:
+    const juce::AudioBuffer<float>& foldToMono(const juce::AudioBuffer<float>& buffer, const juce::AudioBuffer<float>* sidechain);
+    void pushHistory(int numSamples);
+
     float intensity = 0.0f;
     float density = 0.0f;
     float timbre = 0.0f;
 
     double sampleRate = 44100.0;
 
-    // Filters for spectral analysis
-    juce::dsp::IIR::Filter<float> lowFilter;
-    juce::dsp::IIR::Filter<float> midFilter;
-    juce::dsp::IIR::Filter<float> highFilter;
+    // One crossover pass replaces the separate low/mid/high analysis filters
+    BandSplitter bandSplitter;
+
+    // One shared STFT for every consumer that needs a spectrum
+    SpectralAnalyser spectralAnalyser;
+
+    PitchTracker pitchTracker;
+
+    TransientDetector transientDetector;
+
+    // Set while pitch comes from a snapshot rather than the tracker
+    bool pitchFromSnapshot = false;
+    float snapshotPitchHz = 0.0f, snapshotConfidence = 0.0f;
+
+    // Set while following another detector's history
+    bool transientHeld = false;
+    float heldTransient = 0.0f;
+
+    // This detector's outputs for its recent blocks, for delayed followers
+    struct HistoryEntry
+    {
+        Snapshot values;
+        float transientStrength = 0.0f;
+        int numSamples = 0;
+    };
+
+    std::array<HistoryEntry, historySize> history;
+    int historyHead = 0, historyCount = 0;
 
     juce::LinearSmoothedValue<float> smoothedIntensity { 0.0f };
     juce::LinearSmoothedValue<float> smoothedDensity   { 0.0f };
     juce::LinearSmoothedValue<float> smoothedTimbre    { 0.0f };
 
-    juce::AudioBuffer<float> monoBuffer;
-    juce::AudioBuffer<float> analysisBuffer;
+    juce::AudioBuffer<float> monoBuffer; // View onto scratch memory
+    float* monoChannel = nullptr;
+    int maxBlockSize = 0;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (PressureDetector)
 };
@@ -0,0 +1,218 @@
+/*
+  ==============================================================================
+
+    PressureLink.h
+    Process-wide pressure sharing between rack instances. One instance
+    publishes its detector's intensity, density and timbre on a link ID once
+    per block; any number of instances subscribe to that ID and follow it in
+    place of their own pressure analysis.
+
+    Each link is a seqlock slot: the publisher never waits, and subscribers
+    retry a bounded number of times and otherwise keep their last frame. A
+    link goes stale when no frame has arrived for staleSeconds, or when the
+    publisher's timeline position has drifted that far from the
+    subscriber's (a frozen, muted or stopped track). Stale subscribers fall
+    back to their own analysis, picking up from the last linked values.
+
+    Reach the registry through juce::SharedResourcePointer<PressureLink>.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+class PressureLink
+{
+public:
+    static constexpr int numLinks = 16;
+    static constexpr double staleSeconds = 0.25;
+
+    struct Frame
+    {
+        float intensity = 0.0f, density = 0.0f, timbre = 0.0f;
+        juce::int64 position = -1; // Host timeline position of the block in samples; -1 if unknown
+        double sampleRate = 0.0;
+        juce::int64 ticks = 0;     // High-resolution ticks when the block was published
+    };
+
+    PressureLink() {}
+    ~PressureLink() {}
+
+    // One publisher per link: the first claim wins until it is released
+    bool claim(int index, const void* owner)
+    {
+        const void* expected = nullptr;
+        auto& slot = slots[(size_t) index];
+        return slot.owner.compare_exchange_strong(expected, owner, std::memory_order_acq_rel)
+            || expected == owner;
+    }
+
+    void release(int index, const void* owner)
+    {
+        const void* expected = owner;
+        slots[(size_t) index].owner.compare_exchange_strong(expected, nullptr, std::memory_order_acq_rel);
+    }
+
+    // Claimant only; never waits
+    void publish(int index, const Frame& frame)
+    {
+        auto& slot = slots[(size_t) index];
+        auto sequence = slot.sequence.load(std::memory_order_relaxed);
+
+        slot.sequence.store(sequence + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+
+        slot.intensity.store(frame.intensity, std::memory_order_relaxed);
+        slot.density.store(frame.density, std::memory_order_relaxed);
+        slot.timbre.store(frame.timbre, std::memory_order_relaxed);
+        slot.position.store(frame.position, std::memory_order_relaxed);
+        slot.sampleRate.store(frame.sampleRate, std::memory_order_relaxed);
+        slot.ticks.store(frame.ticks, std::memory_order_relaxed);
+
+        slot.sequence.store(sequence + 2, std::memory_order_release);
+    }
+
+    // False if nothing has been published yet or no consistent frame could be read
+    bool read(int index, Frame& frame) const
+    {
+        const auto& slot = slots[(size_t) index];
+
+        for (int attempt = 0; attempt < maxReadAttempts; ++attempt)
+        {
+            auto before = slot.sequence.load(std::memory_order_acquire);
+            if (before == 0)
+                return false;
+            if ((before & 1) != 0)
+                continue;
+
+            Frame copy;
+            copy.intensity = slot.intensity.load(std::memory_order_relaxed);
+            copy.density = slot.density.load(std::memory_order_relaxed);
+            copy.timbre = slot.timbre.load(std::memory_order_relaxed);
+            copy.position = slot.position.load(std::memory_order_relaxed);
+            copy.sampleRate = slot.sampleRate.load(std::memory_order_relaxed);
+            copy.ticks = slot.ticks.load(std::memory_order_relaxed);
+
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (slot.sequence.load(std::memory_order_relaxed) == before)
+            {
+                frame = copy;
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+private:
+    static constexpr int maxReadAttempts = 4;
+
+    struct alignas(64) Slot
+    {
+        std::atomic<const void*> owner { nullptr };
+        std::atomic<juce::uint32> sequence { 0 }; // Odd while a frame is being written
+        std::atomic<float> intensity { 0.0f }, density { 0.0f }, timbre { 0.0f };
+        std::atomic<juce::int64> position { -1 };
+        std::atomic<double> sampleRate { 0.0 };
+        std::atomic<juce::int64> ticks { 0 };
+    };
+
+    std::array<Slot, numLinks> slots;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (PressureLink)
+};
+
+//==============================================================================
+// One instance's connection to the registry: its role, its claim and the last
+// frame it received. Audio thread only, apart from construction.
+class PressureLinkPort
+{
+public:
+    enum Mode { linkOff = 0, linkPublish, linkSubscribe };
+
+    PressureLinkPort() {}
+    ~PressureLinkPort() { releaseClaim(); }
+
+    // Once per block. linkID is 1-based, as shown to the user.
+    void setRoute(Mode newMode, int linkID)
+    {
+        const int newIndex = juce::jlimit(0, PressureLink::numLinks - 1, linkID - 1);
+        if (newMode == mode && newIndex == index && (mode != linkPublish || claimed))
+            return;
+
+        releaseClaim();
+        mode = newMode;
+        index = newIndex;
+        hasFrame = false;
+
+        // Retried every block while another instance holds the link
+        if (mode == linkPublish)
+            claimed = link->claim(index, this);
+    }
+
+    bool isPublishing() const { return mode == linkPublish && claimed; }
+    bool isSubscribing() const { return mode == linkSubscribe; }
+
+    void publish(float intensity, float density, float timbre, juce::int64 position, double sampleRate)
+    {
+        if (! isPublishing())
+            return;
+
+        PressureLink::Frame frame;
+        frame.intensity = intensity;
+        frame.density = density;
+        frame.timbre = timbre;
+        frame.position = position;
+        frame.sampleRate = sampleRate;
+        frame.ticks = juce::Time::getHighResolutionTicks();
+        link->publish(index, frame);
+    }
+
+    // The publisher's latest values, or nullptr if the link is stale and the caller
+    // should run its own analysis
+    const PressureLink::Frame* receive(juce::int64 position, double sampleRate)
+    {
+        if (! isSubscribing())
+            return nullptr;
+
+        PressureLink::Frame frame;
+        if (link->read(index, frame))
+        {
+            latest = frame;
+            hasFrame = true;
+        }
+
+        if (! hasFrame)
+            return nullptr;
+
+        auto age = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - latest.ticks);
+        if (age > PressureLink::staleSeconds)
+            return nullptr;
+
+        if (position >= 0 && latest.position >= 0 && sampleRate > 0.0 && latest.sampleRate > 0.0
+            && std::abs((double) position / sampleRate - (double) latest.position / latest.sampleRate) > PressureLink::staleSeconds)
+            return nullptr;
+
+        return &latest;
+    }
+
+private:
+    void releaseClaim()
+    {
+        if (claimed)
+            link->release(index, this);
+        claimed = false;
+    }
+
+    juce::SharedResourcePointer<PressureLink> link;
+    Mode mode = linkOff;
+    int index = 0;
+    bool claimed = false;
+
+    PressureLink::Frame latest;
+    bool hasFrame = false;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (PressureLinkPort)
+};
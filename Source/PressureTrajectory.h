@@ -0,0 +1,257 @@
+/*
+  ==============================================================================
+
+    PressureTrajectory.h
+    Pass one of a two-pass offline render: the detector's block-rate outputs
+    for a whole take, computed once and stored compactly so later renders
+    can skip the analysis.
+
+    With the whole take available the trajectory need not be causal. The
+    intensity, density and timbre measurements get a zero-phase version of
+    the live smoothing (forward and backward), so they no longer trail the
+    voice. The pitch estimate is moved earlier by the tracker's frame
+    latency.
+
+    File layout (little-endian), mapped in place when read back:
+        char[4]  magic "VAPT"
+        uint16   format version
+        uint16   flags (bit 0: mono input)
+        uint32   block size
+        uint32   point count
+        float64  sample rate
+        uint64   key of the source audio and analysis settings
+        points:  float32 intensity, density, timbre, pitch Hz, pitch confidence
+
+    Bump currentVersion whenever the detector's analysis changes, so stale
+    cached trajectories stop matching.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "PressureDetector.h"
+
+class PressureTrajectory
+{
+public:
+    using Point = PressureDetector::Snapshot;
+    static_assert (sizeof (Point) == 5 * sizeof (float), "Points are stored as five packed floats");
+
+    static constexpr juce::uint16 currentVersion = 2;
+    static constexpr size_t headerSize = 32;
+
+    PressureTrajectory() {}
+    ~PressureTrajectory() {}
+
+    // Identifies a trajectory: the audio itself plus everything that shapes the analysis
+    static juce::uint64 makeKey(const juce::AudioBuffer<float>& input, double sampleRate, int blockSize, bool monoInput)
+    {
+        juce::uint64 h = 14695981039346656037ull;
+        auto mix = [&h](const void* data, size_t numBytes)
+        {
+            for (auto* p = static_cast<const unsigned char*>(data); numBytes-- > 0; ++p)
+            {
+                h ^= *p;
+                h *= 1099511628211ull;
+            }
+        };
+
+        const int numChannels = monoInput ? 1 : juce::jmin(2, input.getNumChannels());
+        const int numSamples = input.getNumSamples();
+        mix(&currentVersion, sizeof (currentVersion));
+        mix(&sampleRate, sizeof (sampleRate));
+        mix(&blockSize, sizeof (blockSize));
+        mix(&numChannels, sizeof (numChannels));
+        mix(&numSamples, sizeof (numSamples));
+
+        for (int channel = 0; channel < numChannels; ++channel)
+            mix(input.getReadPointer(channel), (size_t) numSamples * sizeof (float));
+
+        return h;
+    }
+
+    // Pass one: runs the detector over the whole input on the serial render's block grid
+    void analyse(const juce::AudioBuffer<float>& input, double sampleRate, int blockSizeToUse, bool monoInput, juce::uint64 keyToUse)
+    {
+        blockSize = blockSizeToUse;
+        rate = sampleRate;
+        mono = monoInput;
+        key = keyToUse;
+        mapped.reset();
+
+        const int numChannels = monoInput ? 1 : 2;
+        const int length = input.getNumSamples();
+        const int inputChannels = juce::jmin(numChannels, input.getNumChannels());
+        numPoints = (length + blockSize - 1) / blockSize;
+
+        juce::dsp::ProcessSpec spec;
+        spec.sampleRate = sampleRate;
+        spec.maximumBlockSize = (juce::uint32) blockSize;
+        spec.numChannels = (juce::uint32) numChannels;
+
+        PressureDetector detector;
+        detector.prepare(spec);
+        detector.setUseWorkerPool(false);
+        std::vector<float> scratch (PressureDetector::getScratchSize(spec));
+        detector.setScratch(scratch.data());
+
+        std::vector<Point> raw ((size_t) numPoints);
+        juce::AudioBuffer<float> work (numChannels, blockSize);
+        work.clear();
+
+        for (int b = 0; b < numPoints; ++b)
+        {
+            const int position = b * blockSize;
+            const int numSamples = juce::jmin(blockSize, length - position);
+            juce::AudioBuffer<float> block (work.getArrayOfWritePointers(), numChannels, numSamples);
+            for (int channel = 0; channel < inputChannels; ++channel)
+                block.copyFrom(channel, 0, input, channel, position, numSamples);
+
+            detector.process(block);
+            raw[(size_t) b] = detector.getUnsmoothedSnapshot();
+        }
+
+        // The live smoothers move 1/steps of the way each block; run that forwards and
+        // backwards so the result is centred on the block instead of trailing it
+        ownedPoints.assign((size_t) numPoints, Point());
+        std::vector<float> forward ((size_t) numPoints);
+        auto zeroPhase = [&](float Point::* field, double steps)
+        {
+            if (numPoints == 0)
+                return;
+
+            const float coefficient = (float) (1.0 / juce::jmax(1.0, steps));
+            float y = raw.front().*field;
+            for (int b = 0; b < numPoints; ++b)
+            {
+                y += coefficient * (raw[(size_t) b].*field - y);
+                forward[(size_t) b] = y;
+            }
+
+            y = forward.back();
+            for (int b = numPoints - 1; b >= 0; --b)
+            {
+                y += coefficient * (forward[(size_t) b] - y);
+                ownedPoints[(size_t) b].*field = y;
+            }
+        };
+
+        zeroPhase(&Point::intensity, PressureDetector::intensitySmoothingSeconds * sampleRate);
+        zeroPhase(&Point::density, PressureDetector::shapeSmoothingSeconds * sampleRate);
+        zeroPhase(&Point::timbre, PressureDetector::shapeSmoothingSeconds * sampleRate);
+
+        // Each pitch estimate describes audio one analysis frame back
+        const int pitchShift = juce::roundToInt((double) detector.getPitchLatencySamples() / blockSize);
+        for (int b = 0; b < numPoints; ++b)
+        {
+            const auto& source = raw[(size_t) juce::jmin(b + pitchShift, numPoints - 1)];
+            ownedPoints[(size_t) b].pitchHz = source.pitchHz;
+            ownedPoints[(size_t) b].pitchConfidence = source.pitchConfidence;
+        }
+
+        points = ownedPoints.data();
+    }
+
+    bool save(const juce::File& file) const
+    {
+        juce::MemoryBlock data (headerSize + (size_t) numPoints * sizeof (Point));
+        auto* out = static_cast<char*>(data.getData());
+
+        std::memcpy(out, magic, 4);
+        writeUInt16(out + 4, currentVersion);
+        writeUInt16(out + 6, mono ? 1 : 0);
+        writeUInt32(out + 8, (juce::uint32) blockSize);
+        writeUInt32(out + 12, (juce::uint32) numPoints);
+        juce::uint64 rateBits;
+        std::memcpy(&rateBits, &rate, 8);
+        writeUInt64(out + 16, rateBits);
+        writeUInt64(out + 24, key);
+        out += headerSize;
+
+        for (int b = 0; b < numPoints; ++b, out += sizeof (Point))
+        {
+            const auto& p = points[b];
+            writeFloat(out,      p.intensity);
+            writeFloat(out + 4,  p.density);
+            writeFloat(out + 8,  p.timbre);
+            writeFloat(out + 12, p.pitchHz);
+            writeFloat(out + 16, p.pitchConfidence);
+        }
+
+        return file.replaceWithData(data.getData(), data.getSize());
+    }
+
+    // Maps a saved trajectory in place. False if it's missing, damaged or for other
+    // audio or settings; the caller then runs analyse().
+    bool load(const juce::File& file, juce::uint64 expectedKey, int expectedBlockSize, bool expectedMono)
+    {
+       #if JUCE_BIG_ENDIAN
+        // Points are read in place as native floats
+        juce::ignoreUnused (file, expectedKey, expectedBlockSize, expectedMono);
+        return false;
+       #else
+        auto map = std::make_unique<juce::MemoryMappedFile>(file, juce::MemoryMappedFile::readOnly);
+        auto* in = static_cast<const char*>(map->getData());
+        const size_t size = map->getSize();
+
+        if (in == nullptr || size < headerSize || std::memcmp(in, magic, 4) != 0)
+            return false;
+
+        // The key already covers the block size and mono flag; checking the header's own
+        // copies as well stops a damaged file being read with the wrong layout
+        const auto count = readUInt32(in + 12);
+        if (readUInt16(in + 4) != currentVersion || readUInt64(in + 24) != expectedKey
+             || count > (size - headerSize) / sizeof (Point) || count > (juce::uint32) std::numeric_limits<int>::max()
+             || readUInt32(in + 8) != (juce::uint32) expectedBlockSize
+             || ((readUInt16(in + 6) & 1) != 0) != expectedMono)
+            return false;
+
+        ownedPoints.clear();
+        mono = expectedMono;
+        blockSize = expectedBlockSize;
+        numPoints = (int) count;
+        auto rateBits = readUInt64(in + 16);
+        std::memcpy(&rate, &rateBits, 8);
+        key = expectedKey;
+        points = reinterpret_cast<const Point*>(in + headerSize);
+        mapped = std::move(map);
+        return true;
+       #endif
+    }
+
+    // The point for the block starting at blockIndex * getBlockSize(); past the end, the last
+    const Point& getPoint(int blockIndex) const
+    {
+        jassert (numPoints > 0);
+        return points[juce::jlimit(0, numPoints - 1, blockIndex)];
+    }
+
+    int getNumPoints() const { return numPoints; }
+    int getBlockSize() const { return blockSize; }
+    size_t getSizeBytes() const { return headerSize + (size_t) numPoints * sizeof (Point); }
+
+private:
+    static constexpr char magic[4] = { 'V', 'A', 'P', 'T' };
+
+    static void writeUInt16(char* p, juce::uint16 v) { v = juce::ByteOrder::swapIfBigEndian(v); std::memcpy(p, &v, 2); }
+    static void writeUInt32(char* p, juce::uint32 v) { v = juce::ByteOrder::swapIfBigEndian(v); std::memcpy(p, &v, 4); }
+    static void writeUInt64(char* p, juce::uint64 v) { v = juce::ByteOrder::swapIfBigEndian(v); std::memcpy(p, &v, 8); }
+    static void writeFloat(char* p, float f)          { juce::uint32 v; std::memcpy(&v, &f, 4); writeUInt32(p, v); }
+
+    static juce::uint16 readUInt16(const char* p) { juce::uint16 v; std::memcpy(&v, p, 2); return juce::ByteOrder::swapIfBigEndian(v); }
+    static juce::uint32 readUInt32(const char* p) { juce::uint32 v; std::memcpy(&v, p, 4); return juce::ByteOrder::swapIfBigEndian(v); }
+    static juce::uint64 readUInt64(const char* p) { juce::uint64 v; std::memcpy(&v, p, 8); return juce::ByteOrder::swapIfBigEndian(v); }
+
+    std::vector<Point> ownedPoints;                 // After analyse()
+    std::unique_ptr<juce::MemoryMappedFile> mapped; // After load()
+    const Point* points = nullptr;
+    int numPoints = 0;
+
+    int blockSize = 0;
+    double rate = 0.0;
+    bool mono = false;
+    juce::uint64 key = 0;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (PressureTrajectory)
+};
@@ -0,0 +1,554 @@
+/*
+  ==============================================================================
+
+    RackChain.h
+    The module chain for one vocal bus, from Dynamics to The Wall. The
+    processor runs one chain per bus, all reacting to a single shared
+    PressureDetector; chains run one after another, so their block-local
+    scratch shares the same arena memory.
+
+    The spectral stages (de-reverb and Tame) each add a frame of latency,
+    and the chain always reports both. A stage only runs while its settings
+    engage it; otherwise its input passes through a plain delay of the same
+    length, and engaging or releasing one crossfades between the two. Stages
+    after a spectral stage hear the audio late, so they read the detector's
+    outputs delayed to match.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "PressureDetector.h"
+#include "DynamicsModule.h"
+#include "EQModule.h"
+#include "HarshnessModule.h"
+#include "HarmonicsModule.h"
+#include "ShiftModule.h"
+#include "SpaceModule.h"
+#include "ClipperModule.h"
+#include "WidenerModule.h"
+#include "MakeupGainModule.h"
+#include "ScratchArena.h"
+#include "BypassManager.h"
+#include "RackSettings.h"
+
+class RackChain
+{
+public:
+    // Where each scratch buffer is live while this chain runs, in chain order
+    enum Stage
+    {
+        stageInput = 0,
+        stageDynamics,
+        stageEQ,
+        stageHarmonics,
+        stageShift,
+        stageSpace,
+        stageWidener,
+        stageMuscle,
+        stageWall,
+        numStages
+    };
+
+    // Which stages are switched in this block
+    struct Switches
+    {
+        bool dynamics = true, eq = true, harmonics = true, shift = true, space = true;
+    };
+
+    RackChain() {}
+    ~RackChain() {}
+
+    // spec.numChannels is the bus's output width. A mono input feeding a stereo
+    // output runs the stages ahead of Shift on channel 0 alone.
+    void prepare(const juce::dsp::ProcessSpec& spec, bool monoInput)
+    {
+        busSpec = spec;
+        monoToStereo = monoInput && spec.numChannels == 2;
+        numChannels = (int) spec.numChannels;
+        blockSize = (int) spec.maximumBlockSize;
+
+        auto chainSpec = spec;
+        chainSpec.numChannels = monoToStereo ? 1 : spec.numChannels;
+        chainChannels = (int) chainSpec.numChannels;
+
+        dynamicsModule.prepare(chainSpec);
+        eqModule.prepare(chainSpec);
+        harshnessModule.prepare(chainSpec);
+        harmonicsModule.prepare(chainSpec);
+        shiftModule.prepare(spec);
+        spaceModule.prepare(spec);
+        widenerModule.prepare(spec);
+        clipperModule.prepare(spec);
+        makeupGainModule.prepare(spec);
+        bypassManager.prepare(spec);
+
+        deReverbStage.latency = dynamicsModule.getLatencySamples();
+        tameStage.latency = harshnessModule.getLatencySamples();
+        maxLatency = deReverbStage.latency + tameStage.latency;
+        rampLength = juce::jmax(1, juce::roundToInt(spec.sampleRate * BypassManager::rampSeconds));
+        releaseHoldSamples = juce::roundToInt(spec.sampleRate * releaseHoldSeconds);
+
+        for (auto* s : { &deReverbStage, &tameStage })
+        {
+            s->wanted = s->engaged = s->running = false;
+            s->gain = 0.0f;
+            s->offSamples = s->primeSamples = 0;
+            s->bypassDelay.prepare(chainSpec);
+            s->bypassDelay.setMaximumDelayInSamples(juce::jmax(1, s->latency));
+            s->bypassDelay.setDelay((float) s->latency);
+        }
+        primed = false;
+
+        // The spectral stages delay the wet path by one frame each; the dry path for
+        // "The Muscle" is delayed to match so the parallel blend doesn't comb.
+        dryDelay.prepare(chainSpec);
+        dryDelay.setMaximumDelayInSamples(juce::jmax(1, maxLatency));
+        dryDelay.setDelay((float) maxLatency);
+    }
+
+    // Reserves this chain's buffers with its stages numbered from firstStage
+    void reserveScratch(ScratchArena& arena, int firstStage)
+    {
+        auto stage = [firstStage](Stage s) { return firstStage + (int) s; };
+        auto chainSpec = busSpec;
+        chainSpec.numChannels = (juce::uint32) chainChannels;
+
+        dryHandle       = arena.reserve((size_t) (chainChannels * blockSize), stage(stageInput), stage(stageMuscle));
+        harmonicsHandle = arena.reserve(HarmonicsModule::getScratchSize(chainSpec), stage(stageHarmonics), stage(stageHarmonics));
+        shiftHandle     = arena.reserve(ShiftModule::getScratchSize(busSpec), stage(stageShift), ScratchArena::persistent);
+        fadeHandle      = arena.reserve(BypassManager::getScratchSize(busSpec), stage(stageDynamics), stage(stageSpace));
+        latentHandle    = arena.reserve((size_t) (chainChannels * blockSize), stage(stageDynamics), stage(stageEQ));
+    }
+
+    // Call after the arena is allocated
+    void setScratch(const ScratchArena& arena)
+    {
+        dryChannels.resize((size_t) chainChannels);
+        for (int channel = 0; channel < chainChannels; ++channel)
+            dryChannels[(size_t) channel] = arena.get(dryHandle) + (size_t) (channel * blockSize);
+        dryBuffer.setDataToReferTo(dryChannels.data(), chainChannels, blockSize);
+
+        latentChannels.resize((size_t) chainChannels);
+        for (int channel = 0; channel < chainChannels; ++channel)
+            latentChannels[(size_t) channel] = arena.get(latentHandle) + (size_t) (channel * blockSize);
+        latentFadeBuffer.setDataToReferTo(latentChannels.data(), chainChannels, blockSize);
+
+        harmonicsModule.setScratch(arena.get(harmonicsHandle));
+        shiftModule.setScratch(arena.get(shiftHandle));
+        bypassManager.setScratch(arena.get(fadeHandle));
+    }
+
+    void applySettings(const RackSettings& settings)
+    {
+        dynamicsModule.functionAmount  = settings.dynFunction;
+        dynamicsModule.sustainCut      = settings.dynSustain;
+        dynamicsModule.deReverbEnabled = settings.dynDeReverb;
+
+        eqModule.scoopAmount       = settings.eqScoop;
+        eqModule.biteAmount        = settings.eqBite;
+        harshnessModule.tameAmount = settings.eqTame;
+
+        harmonicsModule.gritAmount    = settings.harmGrit;
+        harmonicsModule.clarityAmount = settings.harmClarity;
+
+        shiftModule.pitchShift    = settings.shiftPitch;
+        shiftModule.formantShift  = settings.shiftFormant;
+        shiftModule.doublerVoices = settings.shiftVoices;
+        shiftModule.doublerSpread = settings.shiftSpread;
+
+        spaceModule.mixAmount       = settings.spaceMix;
+        spaceModule.characterAmount = settings.spaceCharacter;
+
+        makeupGainModule.mode       = (MakeupGainModule::Mode) settings.makeupMode;
+        makeupGainModule.targetLUFS = settings.makeupTarget;
+
+        // Engaging takes effect at once; releasing waits in process()
+        deReverbStage.wanted = dynamicsModule.isDeReverbEngaged();
+        tameStage.wanted = harshnessModule.isEngaged();
+        for (auto* s : { &deReverbStage, &tameStage })
+        {
+            if (s->wanted)
+            {
+                s->engaged = true;
+                s->offSamples = 0;
+            }
+        }
+    }
+
+    // buffer holds this bus's output channels with its input already in place
+    void process(juce::AudioBuffer<float>& buffer, const PressureDetector& detector,
+                 const Switches& switches, const RackSettings& settings)
+    {
+        processThroughSpace(buffer, detector, switches);
+        processOutputStages(buffer, settings);
+    }
+
+    // process() in two halves: every stage up to Space, then the output stages (The Void,
+    // The Muscle, makeup and The Wall). The output stages of several chains can run at once
+    // through processOutputStagesPacked() instead.
+    void processThroughSpace(juce::AudioBuffer<float>& buffer, const PressureDetector& detector, const Switches& switches)
+    {
+        const int numSamples = buffer.getNumSamples();
+        juce::AudioBuffer<float> chain (buffer.getArrayOfWritePointers(), chainChannels, numSamples);
+
+        for (auto* s : { &deReverbStage, &tameStage })
+        {
+            if (s->engaged && ! s->wanted && (s->offSamples += numSamples) >= releaseHoldSamples)
+                s->engaged = false;
+
+            // Nothing has been heard yet, so the first block starts in the settled state
+            if (! primed)
+            {
+                s->running = s->engaged;
+                s->gain = s->engaged ? 1.0f : 0.0f;
+                s->primeSamples = 0;
+            }
+        }
+        primed = true;
+
+        // What the stages after each spectral stage hear is that much older than the
+        // detector's latest block
+        const auto& afterDeReverb = followDelayed(deReverbDetector, detector, deReverbStage.latency);
+        const auto& afterTame = followDelayed(tameDetector, detector, deReverbStage.latency + tameStage.latency);
+
+        if (monoToStereo)
+        {
+            // A mono source is heard on both speakers, so measure it as such
+            float* bothSides[] = { buffer.getWritePointer(0), buffer.getWritePointer(0) };
+            makeupGainModule.measureInput(juce::AudioBuffer<float> (bothSides, 2, numSamples));
+        }
+        else
+        {
+            makeupGainModule.measureInput(buffer);
+        }
+
+        // "The Muscle" - Store dry signal
+        for (int i = 0; i < chainChannels; ++i)
+            dryBuffer.copyFrom(i, 0, chain.getReadPointer(i), numSamples);
+
+        juce::dsp::AudioBlock<float> dryBlock (dryBuffer.getArrayOfWritePointers(), (size_t) chainChannels, (size_t) numSamples);
+        dryDelay.process (juce::dsp::ProcessContextReplacing<float> (dryBlock));
+
+        // Bypass toggles crossfade; bypassed stages don't run
+        bypassManager.process(BypassManager::dynamics, chain, switches.dynamics,
+                              [this, &detector](juce::AudioBuffer<float>& b) { dynamicsModule.process(b, detector); });
+
+        // While engaged these run even when bypassed, so the audio stays aligned with the
+        // delayed detector
+        processLatent(deReverbStage, chain,
+                      [this, &switches](juce::AudioBuffer<float>& b) { dynamicsModule.processDeReverb(b, switches.dynamics); },
+                      [this] { dynamicsModule.resetDeReverb(); });
+
+        bypassManager.process(BypassManager::eq, chain, switches.eq,
+                              [this, &afterDeReverb](juce::AudioBuffer<float>& b) { eqModule.process(b, afterDeReverb); });
+
+        processLatent(tameStage, chain,
+                      [this, &afterDeReverb, &switches](juce::AudioBuffer<float>& b) { harshnessModule.process(b, afterDeReverb, switches.eq); },
+                      [this] { harshnessModule.reset(); });
+
+        bypassManager.process(BypassManager::harmonics, chain, switches.harmonics,
+                              [this, &afterTame](juce::AudioBuffer<float>& b) { harmonicsModule.process(b, afterTame); });
+
+        // Width starts here: the doubler, Space and The Void all need two channels
+        if (monoToStereo)
+            buffer.copyFrom(1, 0, buffer, 0, 0, numSamples);
+
+        bypassManager.process(BypassManager::shift, buffer, switches.shift,
+                              [this, &afterTame](juce::AudioBuffer<float>& b) { shiftModule.process(b, afterTame); });
+
+        bypassManager.process(BypassManager::space, buffer, switches.space,
+                              [this, &afterTame](juce::AudioBuffer<float>& b) { spaceModule.process(b, afterTame); });
+
+        outputDetector = &afterTame;
+    }
+
+    void processOutputStages(juce::AudioBuffer<float>& buffer, const RackSettings& settings)
+    {
+        const int numSamples = buffer.getNumSamples();
+
+        // The Void and The Wall
+        widenerModule.process(buffer, *outputDetector, settings.voidWidth);
+
+        // Parallel Blend (The Muscle)
+        float mix = settings.muscle;
+        for (int channel = 0; channel < numChannels; ++channel)
+        {
+            auto* dryData = dryBuffer.getReadPointer(juce::jmin(channel, chainChannels - 1));
+            auto* wetData = buffer.getWritePointer(channel);
+            for (int sample = 0; sample < numSamples; ++sample)
+                wetData[sample] = dryData[sample] * (1.0f - mix) + wetData[sample] * mix;
+        }
+
+        // Loudness makeup, so The Wall sees a consistent level
+        makeupGainModule.process(buffer);
+
+        clipperModule.process(buffer, settings.wallDrive, settings.wallCeiling);
+    }
+
+    using Lanes = ClipperModule::Lanes;
+    static constexpr int numLanes = ClipperModule::numLanes;
+
+    // Scratch for processOutputStagesPacked(), in floats
+    static size_t getPackedScratchSize(int maximumBlockSize) { return (size_t) (3 * maximumBlockSize * numLanes); }
+
+    // The output stages of up to numLanes stereo chains at once, one chain per SIMD lane,
+    // each after its own processThroughSpace() on a block of the same length. Lane for lane
+    // the arithmetic is processOutputStages()'s, so every chain's output and state come out
+    // the same. packed is getPackedScratchSize() floats, aligned for Lanes.
+    static void processOutputStagesPacked(RackChain* const* chains, juce::AudioBuffer<float>* const* buffers,
+                                          const RackSettings* const* settings, int numChains, float* packed)
+    {
+        jassert (numChains > 0 && numChains <= numLanes);
+        const int numSamples = buffers[0]->getNumSamples();
+
+        auto* lanes = reinterpret_cast<Lanes*>(packed);
+        Lanes* channels[] = { lanes, lanes + numSamples };
+        Lanes* aux = lanes + 2 * numSamples;
+
+        // Sample i of chain m lives in lane m of element i; spare lanes run on silence
+        auto gather = [numSamples, numChains](Lanes* dest, auto&& sourceOf)
+        {
+            auto* d = reinterpret_cast<float*>(dest);
+            for (int m = 0; m < numLanes; ++m)
+            {
+                const float* source = m < numChains ? sourceOf(m) : nullptr;
+                for (int i = 0; i < numSamples; ++i)
+                    d[i * numLanes + m] = source != nullptr ? source[i] : 0.0f;
+            }
+        };
+
+        auto scatter = [numSamples, numChains, buffers, &channels](int channel)
+        {
+            auto* s = reinterpret_cast<const float*>(channels[channel]);
+            for (int m = 0; m < numChains; ++m)
+            {
+                auto* d = buffers[m]->getWritePointer(channel);
+                for (int i = 0; i < numSamples; ++i)
+                    d[i] = s[i * numLanes + m];
+            }
+        };
+
+        auto sideGain = Lanes::expand(1.0f), mix = Lanes::expand(1.0f), dryGain = Lanes::expand(0.0f);
+        for (int m = 0; m < numChains; ++m)
+        {
+            jassert (chains[m]->numChannels == 2 && buffers[m]->getNumSamples() == numSamples);
+            sideGain.set((size_t) m, WidenerModule::getSideGain(*chains[m]->outputDetector, settings[m]->voidWidth));
+            mix.set((size_t) m, settings[m]->muscle);
+            dryGain.set((size_t) m, 1.0f - settings[m]->muscle);
+        }
+
+        for (int channel = 0; channel < 2; ++channel)
+            gather(channels[channel], [buffers, channel](int m) { return buffers[m]->getReadPointer(channel); });
+
+        // The Void
+        const auto half = Lanes::expand(0.5f);
+        for (int i = 0; i < numSamples; ++i)
+        {
+            auto mid = (channels[0][i] + channels[1][i]) * half;
+            auto side = (channels[0][i] - channels[1][i]) * half;
+            side = side * sideGain;
+            channels[0][i] = mid + side;
+            channels[1][i] = mid - side;
+        }
+
+        // The Muscle
+        for (int channel = 0; channel < 2; ++channel)
+        {
+            gather(aux, [chains, channel](int m)
+            {
+                return chains[m]->dryBuffer.getReadPointer(juce::jmin(channel, chains[m]->chainChannels - 1));
+            });
+
+            for (int i = 0; i < numSamples; ++i)
+                channels[channel][i] = aux[i] * dryGain + channels[channel][i] * mix;
+        }
+
+        // Makeup measures each chain on its own, so the blend goes back out first
+        scatter(0);
+        scatter(1);
+
+        auto* gains = reinterpret_cast<float*>(aux);
+        for (int m = 0; m < numChains; ++m)
+        {
+            auto& makeup = chains[m]->makeupGainModule;
+            const bool applies = makeup.measure(*buffers[m]);
+            for (int i = 0; i < numSamples; ++i)
+                gains[i * numLanes + m] = applies ? makeup.getNextGain() : 1.0f;
+        }
+
+        for (int channel = 0; channel < 2; ++channel)
+            for (int i = 0; i < numSamples; ++i)
+                channels[channel][i] = channels[channel][i] * aux[i];
+
+        // The Wall
+        std::array<ClipperModule*, (size_t) numLanes> clippers {};
+        std::array<float, (size_t) numLanes> drive {}, ceiling {};
+        for (int m = 0; m < numChains; ++m)
+        {
+            clippers[(size_t) m] = &chains[m]->clipperModule;
+            drive[(size_t) m] = settings[m]->wallDrive;
+            ceiling[(size_t) m] = settings[m]->wallCeiling;
+        }
+
+        ClipperModule::processPacked(clippers.data(), numChains, channels, 2, numSamples, drive.data(), ceiling.data());
+
+        scatter(0);
+        scatter(1);
+    }
+
+    // Both spectral stages' latency, whether or not they're engaged
+    int getLatencySamples() const { return maxLatency; }
+
+    // Channels the stages ahead of Shift run on: 1 for a mono input, else the bus width
+    int getInputChannels() const { return chainChannels; }
+
+    // How long the chain can keep sounding after its input goes silent, excluding the reverb
+    int getRingSamples() const { return maxLatency + shiftModule.getTailSamples(); }
+    float getReverbTailSeconds() const { return spaceModule.getTailSeconds(); }
+
+    const DynamicsModule&   getDynamics() const   { return dynamicsModule; }
+    const EQModule&         getEQ() const         { return eqModule; }
+    const HarshnessModule&  getHarshness() const  { return harshnessModule; }
+    const ShiftModule&      getShift() const      { return shiftModule; }
+    const SpaceModule&      getSpace() const      { return spaceModule; }
+    SpaceModule&            getSpace()            { return spaceModule; }
+    const MakeupGainModule& getMakeupGain() const { return makeupGainModule; }
+    const ClipperModule&    getClipper() const    { return clipperModule; }
+
+private:
+    // A spectral stage that only runs while engaged; otherwise bypassDelay stands in for it
+    struct LatentStage
+    {
+        int latency = 0;
+        bool wanted = false;  // The settings engage it
+        bool engaged = false; // Released once unwanted for releaseHoldSeconds
+        bool running = false;
+        float gain = 0.0f;    // 0 = bypass delay only, 1 = fully in
+        int offSamples = 0;
+        int primeSamples = 0; // Left before a restarted stage's output is whole
+        juce::dsp::DelayLine<float, juce::dsp::DelayLineInterpolationTypes::None> bypassDelay;
+    };
+
+    // Sweeps and morphs across a stage's threshold shouldn't keep restarting it
+    static constexpr double releaseHoldSeconds = 0.5;
+
+    const PressureDetector& followDelayed(PressureDetector& view, const PressureDetector& detector, int delaySamples)
+    {
+        if (delaySamples == 0)
+            return detector;
+
+        view.followDelayed(detector, delaySamples);
+        return view;
+    }
+
+    // Runs an engaged stage, or delays its input by the stage's latency instead; engaging or
+    // releasing crossfades between the two, like a bypass toggle. The delay runs throughout
+    // so it can take over at any time. A stage coming back in starts from cleared state and
+    // is only faded in once its first frame has filled.
+    template <typename ProcessFunction, typename ResetFunction>
+    void processLatent(LatentStage& s, juce::AudioBuffer<float>& chain, ProcessFunction&& processStage, ResetFunction&& resetStage)
+    {
+        const int numSamples = chain.getNumSamples();
+        for (int channel = 0; channel < chainChannels; ++channel)
+            latentFadeBuffer.copyFrom(channel, 0, chain, channel, 0, numSamples);
+
+        juce::dsp::AudioBlock<float> delayedBlock (latentFadeBuffer.getArrayOfWritePointers(), (size_t) chainChannels, (size_t) numSamples);
+        s.bypassDelay.process (juce::dsp::ProcessContextReplacing<float> (delayedBlock));
+
+        auto useDelayed = [&]
+        {
+            for (int channel = 0; channel < chainChannels; ++channel)
+                chain.copyFrom(channel, 0, latentFadeBuffer, channel, 0, numSamples);
+        };
+
+        if (! s.running)
+        {
+            if (! s.engaged)
+            {
+                useDelayed();
+                return;
+            }
+
+            resetStage();
+            s.running = true;
+            s.primeSamples = s.latency;
+        }
+
+        processStage(chain);
+
+        if (s.primeSamples > 0)
+        {
+            s.primeSamples -= numSamples;
+            useDelayed();
+            return;
+        }
+
+        const float target = s.engaged ? 1.0f : 0.0f;
+
+        if (s.gain == target)
+        {
+            if (! s.engaged)
+            {
+                s.running = false;
+                useDelayed();
+            }
+            return;
+        }
+
+        const float step = (target > s.gain ? 1.0f : -1.0f) / (float) rampLength;
+        float gain = s.gain;
+
+        for (int channel = 0; channel < chainChannels; ++channel)
+        {
+            auto* wet = chain.getWritePointer(channel);
+            auto* dry = latentFadeBuffer.getReadPointer(channel);
+            gain = s.gain;
+
+            for (int i = 0; i < numSamples; ++i)
+            {
+                gain = juce::jlimit(0.0f, 1.0f, gain + step);
+                wet[i] = dry[i] + gain * (wet[i] - dry[i]);
+            }
+        }
+
+        s.gain = gain;
+        if (s.gain == 0.0f)
+            s.running = false;
+    }
+
+    DynamicsModule   dynamicsModule;
+    EQModule         eqModule;
+    HarshnessModule  harshnessModule;
+    HarmonicsModule  harmonicsModule;
+    ShiftModule      shiftModule;
+    SpaceModule      spaceModule;
+    WidenerModule    widenerModule;
+    MakeupGainModule makeupGainModule;
+    ClipperModule    clipperModule;
+    BypassManager    bypassManager;
+
+    juce::AudioBuffer<float> dryBuffer; // View onto scratch memory
+    std::vector<float*> dryChannels;
+    juce::dsp::DelayLine<float, juce::dsp::DelayLineInterpolationTypes::None> dryDelay;
+
+    LatentStage deReverbStage, tameStage;
+    juce::AudioBuffer<float> latentFadeBuffer; // View onto scratch memory
+    std::vector<float*> latentChannels;
+
+    // The detector's outputs as heard after de-reverb, and after Tame
+    PressureDetector deReverbDetector, tameDetector;
+
+    // What the output stages hear, set by processThroughSpace()
+    const PressureDetector* outputDetector = nullptr;
+
+    ScratchArena::Handle dryHandle = 0, harmonicsHandle = 0, shiftHandle = 0, fadeHandle = 0, latentHandle = 0;
+
+    juce::dsp::ProcessSpec busSpec {};
+    bool monoToStereo = false, primed = false;
+    int numChannels = 0, chainChannels = 0, blockSize = 0;
+    int maxLatency = 0, rampLength = 1, releaseHoldSamples = 0;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (RackChain)
+};
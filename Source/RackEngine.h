@@ -0,0 +1,231 @@
+/*
+  ==============================================================================
+
+    RackEngine.h
+    The rack as a library, for offline pipelines: N independent vocal
+    streams, each with its own settings, detector and chain, processed
+    block by block on the calling thread. No AudioProcessor or host is
+    involved.
+
+    A stream runs exactly the plugin's sequence for a single main bus with
+    no sidechain, pressure link or doubles, rendered offline: silence gate,
+    inline pressure analysis, then the RackChain. So its output matches the
+    plugin's sample for sample, provided it sees the same blocks.
+
+    processAll() takes the streams in groups of RackChain::numLanes. Each
+    stream of a group runs its stages up to Space on its own; then the
+    group's output stages (The Void, The Muscle, makeup and The Wall, with
+    its DC blocker) run together, one stream per SIMD lane. The stages
+    ahead of them stay per stream: their filters take per-stream
+    coefficients from each stream's own detector, and the spectral
+    stages, doubler and reverb have no lane-wise form. Block-local
+    scratch is kept once per lane and shared by the streams that take
+    that lane in successive groups; only state that lives across blocks
+    is per stream.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "PressureDetector.h"
+#include "RackChain.h"
+#include "ScratchArena.h"
+#include "SilenceGate.h"
+#include "RackSettings.h"
+
+class RackEngine
+{
+public:
+    RackEngine() {}
+    ~RackEngine() {}
+
+    // Not real-time safe: allocates every stream's state and the shared scratch.
+    // Streams whose input is mono are processed mono up to Harmonics and leave stereo,
+    // as the plugin does with a mono-in/stereo-out layout.
+    void prepare(double sampleRate, int maximumBlockSize, int numStreams, bool monoInputs = false)
+    {
+        juce::dsp::ProcessSpec spec;
+        spec.sampleRate = sampleRate;
+        spec.maximumBlockSize = (juce::uint32) maximumBlockSize;
+        spec.numChannels = 2;
+
+        auto detectorSpec = spec;
+        detectorSpec.numChannels = monoInputs ? 1 : 2;
+
+        streams.clear();
+        for (int i = 0; i < numStreams; ++i)
+        {
+            auto stream = std::make_unique<Stream>();
+            stream->detector.prepare(detectorSpec);
+            stream->detector.setUseWorkerPool(false);
+            stream->chain.prepare(spec, monoInputs);
+            stream->chain.applySettings(stream->settings);
+            stream->silenceGate.prepare(stream->chain.getRingSamples());
+            streams.push_back(std::move(stream));
+        }
+
+        scratchArena.beginPlan();
+        auto detectorHandle = scratchArena.reserve(PressureDetector::getScratchSize(detectorSpec), 0, ScratchArena::persistent);
+
+        // Streams analyse one at a time, so one detector region serves them all. A group's
+        // chains are all live until its output stages run, so each lane numbers its stages
+        // apart; the streams sharing a lane in successive groups overlap.
+        for (size_t i = 0; i < streams.size(); ++i)
+            streams[i]->chain.reserveScratch(scratchArena, (int) (i % (size_t) RackChain::numLanes) * RackChain::numStages);
+
+        auto packedHandle = scratchArena.reserve(RackChain::getPackedScratchSize(maximumBlockSize), 0, ScratchArena::persistent);
+
+        scratchArena.allocate();
+
+        for (auto& stream : streams)
+        {
+            stream->detector.setScratch(scratchArena.get(detectorHandle));
+            stream->chain.setScratch(scratchArena);
+        }
+
+        packedScratch = scratchArena.get(packedHandle);
+
+        maxBlockSize = maximumBlockSize;
+    }
+
+    int getNumStreams() const { return (int) streams.size(); }
+    int getLatencySamples() const { return streams.empty() ? 0 : streams.front()->chain.getLatencySamples(); }
+    const RackChain& getChain(int stream) const { return streams[(size_t) stream]->chain; }
+    RackChain& getChain(int stream)             { return streams[(size_t) stream]->chain; }
+
+    // Between blocks. Build settings with RackSettings::fromValues() to match a plugin
+    // instance's parameter values.
+    void setStreamSettings(int stream, const RackSettings& settings, const RackChain::Switches& switches = {})
+    {
+        auto& s = *streams[(size_t) stream];
+        s.settings = settings;
+        s.switches = switches;
+        s.chain.applySettings(settings);
+    }
+
+    // One block of one stream, in place: one channel for mono inputs, then two out
+    void process(int stream, juce::AudioBuffer<float>& buffer)
+    {
+        processStream(stream, buffer, nullptr);
+    }
+
+    // The same, with pressure and pitch taken from a precomputed trajectory point
+    // rather than analysed, as in the second pass of a two-pass render
+    void process(int stream, juce::AudioBuffer<float>& buffer, const PressureDetector::Snapshot& snapshot)
+    {
+        processStream(stream, buffer, &snapshot);
+    }
+
+    // The stream's pressure analysis alone, to bring its detector up to date ahead of
+    // where output is needed. The chain and silence gate don't see the block.
+    void analyse(int stream, juce::AudioBuffer<float>& buffer)
+    {
+        auto& s = *streams[(size_t) stream];
+        juce::AudioBuffer<float> input (buffer.getArrayOfWritePointers(), s.chain.getInputChannels(), buffer.getNumSamples());
+        s.detector.process(input);
+    }
+
+    // The same, with pressure and pitch taken from a trajectory point
+    void analyse(int stream, juce::AudioBuffer<float>& buffer, const PressureDetector::Snapshot& snapshot)
+    {
+        auto& s = *streams[(size_t) stream];
+        juce::AudioBuffer<float> input (buffer.getArrayOfWritePointers(), s.chain.getInputChannels(), buffer.getNumSamples());
+        s.detector.processFromSnapshot(input, snapshot);
+    }
+
+    // One block of every stream, all of the same length; buffers[i] belongs to stream i.
+    // The same output as process() on each stream in turn.
+    void processAll(juce::AudioBuffer<float>* const* buffers)
+    {
+        constexpr int numLanes = RackChain::numLanes;
+
+        for (int first = 0; first < getNumStreams(); first += numLanes)
+        {
+            std::array<RackChain*, (size_t) numLanes> chains {};
+            std::array<juce::AudioBuffer<float>*, (size_t) numLanes> running {};
+            std::array<const RackSettings*, (size_t) numLanes> settings {};
+            std::array<int, (size_t) numLanes> indices {};
+            int numRunning = 0;
+
+            for (int i = first; i < juce::jmin(first + numLanes, getNumStreams()); ++i)
+            {
+                if (! processThroughSpace(i, *buffers[i], nullptr))
+                    continue;
+
+                auto& s = *streams[(size_t) i];
+                chains[(size_t) numRunning] = &s.chain;
+                running[(size_t) numRunning] = buffers[i];
+                settings[(size_t) numRunning] = &s.settings;
+                indices[(size_t) numRunning] = i;
+                ++numRunning;
+            }
+
+            if (numRunning == 0)
+                continue;
+
+            RackChain::processOutputStagesPacked(chains.data(), running.data(), settings.data(), numRunning, packedScratch);
+
+            for (int r = 0; r < numRunning; ++r)
+                streams[(size_t) indices[(size_t) r]]->silenceGate.outputProcessed(*running[(size_t) r]);
+        }
+    }
+
+    size_t getScratchFootprintBytes() const { return scratchArena.getFootprintBytes(); }
+
+private:
+    void processStream(int stream, juce::AudioBuffer<float>& buffer, const PressureDetector::Snapshot* snapshot)
+    {
+        if (! processThroughSpace(stream, buffer, snapshot))
+            return;
+
+        auto& s = *streams[(size_t) stream];
+        s.chain.processOutputStages(buffer, s.settings);
+        s.silenceGate.outputProcessed(buffer);
+    }
+
+    // The silence gate, the analysis and the chain up to Space. False, with the block
+    // cleared, if the gate skipped it.
+    bool processThroughSpace(int stream, juce::AudioBuffer<float>& buffer, const PressureDetector::Snapshot* snapshot)
+    {
+        jassert (buffer.getNumSamples() <= maxBlockSize && buffer.getNumChannels() >= 2);
+        auto& s = *streams[(size_t) stream];
+
+        // As the plugin clears its output-only channels
+        for (int channel = s.chain.getInputChannels(); channel < buffer.getNumChannels(); ++channel)
+            buffer.clear(channel, 0, buffer.getNumSamples());
+
+        if (! s.silenceGate.shouldProcess(buffer))
+        {
+            buffer.clear();
+            return false;
+        }
+
+        const int numSamples = buffer.getNumSamples();
+        juce::AudioBuffer<float> input (buffer.getArrayOfWritePointers(), s.chain.getInputChannels(), numSamples);
+
+        if (snapshot != nullptr)
+            s.detector.processFromSnapshot(input, *snapshot);
+        else
+            s.detector.process(input);
+
+        s.chain.processThroughSpace(buffer, s.detector, s.switches);
+        return true;
+    }
+
+    struct Stream
+    {
+        PressureDetector detector;
+        RackChain chain;
+        SilenceGate silenceGate;
+        RackSettings settings;
+        RackChain::Switches switches;
+    };
+
+    std::vector<std::unique_ptr<Stream>> streams;
+    ScratchArena scratchArena;
+    float* packedScratch = nullptr;
+    int maxBlockSize = 0;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (RackEngine)
+};
@@ -0,0 +1,144 @@
+/*
+  ==============================================================================
+
+    RackSettings.h
+    The module-facing values derived from the rack's parameters: the master
+    Intensity scaling already applied, ready to hand to each stage. Plain
+    data, so it can be built on any thread, copied into preset slots and
+    interpolated for A/B morphing.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+struct RackSettings
+{
+    float dynFunction = 0.0f, dynSustain = 0.0f;
+    bool  dynDeReverb = false;
+    float eqScoop = 0.0f, eqBite = 0.0f, eqTame = 0.0f;
+    float harmGrit = 0.0f, harmClarity = 0.0f;
+    float shiftPitch = 0.0f, shiftFormant = 0.0f, shiftSpread = 0.5f;
+    int   shiftVoices = 0;
+    float spaceMix = 0.0f, spaceCharacter = 0.5f;
+    float voidWidth = 0.3f, muscle = 1.0f;
+    float wallDrive = 0.0f, wallCeiling = -0.1f;
+    int   makeupMode = 0;
+    float makeupTarget = -14.0f;
+
+    // Reads the parameters' atomics only, so it is safe from the audio thread too
+    static RackSettings fromParameters(juce::AudioProcessorValueTreeState& apvts)
+    {
+        return fromValues([&apvts](const char* id) { return apvts.getRawParameterValue(id)->load(); });
+    }
+
+    // The same mapping from any source of plain parameter values, keyed by parameter ID
+    template <typename ValueSource>
+    static RackSettings fromValues(ValueSource&& value)
+    {
+        RackSettings s;
+
+        // Master INTENSITY controls the range and depth of all reactive components.
+        // At 0% (0.0), it provides a controlled shaper.
+        // At 100% (1.0), it pushes everything into "monster" territory.
+        float m = value("intensity");
+        float aggressionScale = 0.4f + (m * 1.6f); // 0.4x to 2.0x range
+        auto scaled = [&](const char* id) { return juce::jlimit(0.0f, 1.0f, value(id) * aggressionScale); };
+
+        s.dynFunction = scaled("dyn_amount");
+        s.dynSustain  = scaled("dyn_sustain");
+
+        // De-reverb adds a stage, so whether it runs follows the knobs as set rather than
+        // the Intensity-scaled values that sweep with the master control
+        s.dynDeReverb = value("dyn_amount") < 0.25f && value("dyn_sustain") > 0.0f;
+
+        s.eqScoop = scaled("eq_scoop");
+        s.eqBite  = scaled("eq_bite");
+        s.eqTame  = scaled("eq_tame");
+
+        s.harmGrit    = scaled("harm_grit");
+        s.harmClarity = scaled("harm_clarity");
+
+        // Pitch/Formant shifts become much more extreme as intensity rises
+        float shiftScale = 1.0f + (m * 2.0f); // 1x to 3x sensitivity
+        s.shiftPitch   = (value("shift_pitch") - 0.5f) * 24.0f * shiftScale;
+        s.shiftFormant = (value("shift_formant") - 0.5f) * 24.0f * shiftScale;
+        s.shiftVoices  = (int) value("shift_voices");
+        s.shiftSpread  = value("shift_spread");
+
+        s.spaceMix       = scaled("space_mix");
+        s.spaceCharacter = scaled("space_char");
+
+        s.voidWidth   = value("void_width");
+        s.muscle      = value("muscle");
+        s.wallDrive   = value("wall_drive");
+        s.wallCeiling = value("wall_ceil");
+
+        s.makeupMode   = (int) value("makeup_mode");
+        s.makeupTarget = value("makeup_target");
+        return s;
+    }
+
+    // Calls visit(name, field) for every field, under a name that stays fixed across
+    // versions, so stored settings can be saved and read back by name
+    template <typename Settings, typename Visitor>
+    static void visitFields(Settings& s, Visitor&& visit)
+    {
+        visit("dynFunction", s.dynFunction);
+        visit("dynSustain", s.dynSustain);
+        visit("dynDeReverb", s.dynDeReverb);
+        visit("eqScoop", s.eqScoop);
+        visit("eqBite", s.eqBite);
+        visit("eqTame", s.eqTame);
+        visit("harmGrit", s.harmGrit);
+        visit("harmClarity", s.harmClarity);
+        visit("shiftPitch", s.shiftPitch);
+        visit("shiftFormant", s.shiftFormant);
+        visit("shiftSpread", s.shiftSpread);
+        visit("shiftVoices", s.shiftVoices);
+        visit("spaceMix", s.spaceMix);
+        visit("spaceCharacter", s.spaceCharacter);
+        visit("voidWidth", s.voidWidth);
+        visit("muscle", s.muscle);
+        visit("wallDrive", s.wallDrive);
+        visit("wallCeiling", s.wallCeiling);
+        visit("makeupMode", s.makeupMode);
+        visit("makeupTarget", s.makeupTarget);
+    }
+
+    // Continuous values glide; counts and modes switch at the halfway point
+    static RackSettings interpolate(const RackSettings& a, const RackSettings& b, float t)
+    {
+        auto lerp = [t](float x, float y) { return x + t * (y - x); };
+        const RackSettings& nearest = t < 0.5f ? a : b;
+        RackSettings s;
+
+        s.dynFunction = lerp(a.dynFunction, b.dynFunction);
+        s.dynSustain  = lerp(a.dynSustain, b.dynSustain);
+        s.dynDeReverb = nearest.dynDeReverb;
+        s.eqScoop     = lerp(a.eqScoop, b.eqScoop);
+        s.eqBite      = lerp(a.eqBite, b.eqBite);
+        s.eqTame      = lerp(a.eqTame, b.eqTame);
+        s.harmGrit    = lerp(a.harmGrit, b.harmGrit);
+        s.harmClarity = lerp(a.harmClarity, b.harmClarity);
+
+        s.shiftPitch   = lerp(a.shiftPitch, b.shiftPitch);
+        s.shiftFormant = lerp(a.shiftFormant, b.shiftFormant);
+        s.shiftSpread  = lerp(a.shiftSpread, b.shiftSpread);
+        s.shiftVoices  = nearest.shiftVoices;
+
+        s.spaceMix       = lerp(a.spaceMix, b.spaceMix);
+        s.spaceCharacter = lerp(a.spaceCharacter, b.spaceCharacter);
+
+        s.voidWidth   = lerp(a.voidWidth, b.voidWidth);
+        s.muscle      = lerp(a.muscle, b.muscle);
+        s.wallDrive   = lerp(a.wallDrive, b.wallDrive);
+        s.wallCeiling = lerp(a.wallCeiling, b.wallCeiling);
+
+        s.makeupMode   = nearest.makeupMode;
+        s.makeupTarget = lerp(a.makeupTarget, b.makeupTarget);
+        return s;
+    }
+};
@@ -0,0 +1,458 @@
+/*
+  ==============================================================================
+
+    RealtimeWorkerPool.h
+    Process-wide pool of real-time priority workers shared by every rack
+    instance, for optional work that can run alongside the audio callback.
+
+    Audio threads submit into a lock-free multi-producer injection queue;
+    workers move batches into their own Chase-Lev deque and steal from each
+    other when idle. Every job carries a deadline: a job that is picked up
+    after its deadline is dropped rather than run late, and the submitter
+    keeps its previous result until a fresh one arrives.
+
+    Idle workers yield for a couple of milliseconds after their last job,
+    since callbacks submit in bursts, then park on a semaphore. Submitting
+    pushes onto the queue and, only if a worker is parked, posts the
+    semaphore once. Posting never blocks or takes a lock, so it is safe
+    from an audio thread; a stopped transport leaves every worker asleep.
+
+    Reach it through juce::SharedResourcePointer<RealtimeWorkerPool>, and
+    only from code that will submit: the first reference starts the workers.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+#if JUCE_MAC || JUCE_IOS
+ #include <dispatch/dispatch.h>
+#elif JUCE_WINDOWS
+ #ifndef WIN32_LEAN_AND_MEAN
+  #define WIN32_LEAN_AND_MEAN
+ #endif
+ #ifndef NOMINMAX
+  #define NOMINMAX
+ #endif
+ #include <windows.h>
+#else
+ #include <semaphore.h>
+#endif
+
+//==============================================================================
+// Preallocated by its owner and resubmitted as often as needed; never allocated per block.
+class RealtimeJob
+{
+public:
+    enum State
+    {
+        idle,      // Not submitted, or result already collected
+        queued,
+        running,
+        finished,  // run() completed; the result is ready to collect
+        expired    // Picked up after its deadline and skipped
+    };
+
+    RealtimeJob() {}
+    virtual ~RealtimeJob() {}
+
+    State getState() const noexcept { return (State) state.load(std::memory_order_acquire); }
+    bool isInFlight() const noexcept { auto s = getState(); return s == queued || s == running; }
+
+    // Owner only, once the result (or the miss) has been handled
+    void markCollected() noexcept { state.store(idle, std::memory_order_relaxed); }
+
+protected:
+    virtual void run() = 0;
+
+private:
+    friend class RealtimeWorkerPool;
+
+    std::atomic<int> state { idle };
+    juce::int64 deadlineTicks = 0;
+
+    JUCE_DECLARE_NON_COPYABLE (RealtimeJob)
+};
+
+//==============================================================================
+class RealtimeWorkerPool
+{
+public:
+    static constexpr int maxWorkers = 4;
+    static constexpr int queueCapacity = 1024; // Injection queue and each worker's deque
+
+    RealtimeWorkerPool()
+    {
+        const int numWorkers = juce::jlimit(0, maxWorkers, juce::SystemStats::getNumCpus() - 1);
+
+        for (int i = 0; i < numWorkers; ++i)
+            workers.push_back(std::make_unique<Worker>(*this, i));
+
+        for (auto& w : workers)
+            w->start();
+    }
+
+    ~RealtimeWorkerPool()
+    {
+        for (auto& w : workers)
+            w->signalThreadShouldExit();
+
+        for (size_t i = 0; i < workers.size(); ++i)
+            wakeSignal.post();
+
+        for (auto& w : workers)
+            w->stopThread(1000);
+    }
+
+    bool isAvailable() const noexcept { return ! workers.empty(); }
+
+    // Audio thread safe. The job must be idle. Returns false if the pool is absent or full,
+    // in which case the caller should run the job itself or keep its previous result.
+    bool submit(RealtimeJob& job, juce::int64 deadlineTicks) noexcept
+    {
+        if (workers.empty() || job.getState() != RealtimeJob::idle)
+            return false;
+
+        job.deadlineTicks = deadlineTicks;
+        job.state.store(RealtimeJob::queued, std::memory_order_relaxed);
+
+        if (! injection.push(&job))
+        {
+            job.state.store(RealtimeJob::idle, std::memory_order_relaxed);
+            return false;
+        }
+
+        wakeOne();
+        return true;
+    }
+
+    static juce::int64 deadlineAfterSeconds(double seconds) noexcept
+    {
+        return juce::Time::getHighResolutionTicks()
+             + (juce::int64) (seconds * (double) juce::Time::getHighResolutionTicksPerSecond());
+    }
+
+private:
+    //==============================================================================
+    // Counting semaphore whose post never blocks
+    class WakeSignal
+    {
+    public:
+       #if JUCE_MAC || JUCE_IOS
+        WakeSignal() : semaphore(dispatch_semaphore_create(0)) {}
+        ~WakeSignal() { dispatch_release(semaphore); }
+        void post() noexcept { dispatch_semaphore_signal(semaphore); }
+        void wait() noexcept { dispatch_semaphore_wait(semaphore, DISPATCH_TIME_FOREVER); }
+
+    private:
+        dispatch_semaphore_t semaphore;
+       #elif JUCE_WINDOWS
+        WakeSignal() : semaphore(CreateSemaphoreW(nullptr, 0, maxWorkers * queueCapacity, nullptr)) {}
+        ~WakeSignal() { CloseHandle(semaphore); }
+        void post() noexcept { ReleaseSemaphore(semaphore, 1, nullptr); }
+        void wait() noexcept { WaitForSingleObject(semaphore, INFINITE); }
+
+    private:
+        HANDLE semaphore;
+       #else
+        WakeSignal() { sem_init(&semaphore, 0, 0); }
+        ~WakeSignal() { sem_destroy(&semaphore); }
+        void post() noexcept { sem_post(&semaphore); }
+        void wait() noexcept { while (sem_wait(&semaphore) != 0 && errno == EINTR) {} }
+
+    private:
+        sem_t semaphore;
+       #endif
+
+        JUCE_DECLARE_NON_COPYABLE (WakeSignal)
+    };
+
+    //==============================================================================
+    // Bounded multi-producer / multi-consumer queue (D. Vyukov)
+    class InjectionQueue
+    {
+    public:
+        InjectionQueue()
+        {
+            for (size_t i = 0; i < cells.size(); ++i)
+                cells[i].sequence.store(i, std::memory_order_relaxed);
+        }
+
+        bool push(RealtimeJob* job) noexcept
+        {
+            auto pos = enqueuePos.load(std::memory_order_relaxed);
+            for (;;)
+            {
+                auto& cell = cells[pos & mask];
+                auto seq = cell.sequence.load(std::memory_order_acquire);
+                auto diff = (std::intptr_t) seq - (std::intptr_t) pos;
+
+                if (diff == 0)
+                {
+                    if (enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                    {
+                        cell.job = job;
+                        cell.sequence.store(pos + 1, std::memory_order_release);
+                        return true;
+                    }
+                }
+                else if (diff < 0)
+                {
+                    return false; // Full
+                }
+                else
+                {
+                    pos = enqueuePos.load(std::memory_order_relaxed);
+                }
+            }
+        }
+
+        bool isEmpty() const noexcept
+        {
+            return dequeuePos.load(std::memory_order_seq_cst) == enqueuePos.load(std::memory_order_seq_cst);
+        }
+
+        RealtimeJob* pop() noexcept
+        {
+            auto pos = dequeuePos.load(std::memory_order_relaxed);
+            for (;;)
+            {
+                auto& cell = cells[pos & mask];
+                auto seq = cell.sequence.load(std::memory_order_acquire);
+                auto diff = (std::intptr_t) seq - (std::intptr_t) (pos + 1);
+
+                if (diff == 0)
+                {
+                    if (dequeuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                    {
+                        auto* job = cell.job;
+                        cell.sequence.store(pos + mask + 1, std::memory_order_release);
+                        return job;
+                    }
+                }
+                else if (diff < 0)
+                {
+                    return nullptr; // Empty
+                }
+                else
+                {
+                    pos = dequeuePos.load(std::memory_order_relaxed);
+                }
+            }
+        }
+
+    private:
+        static constexpr size_t mask = (size_t) queueCapacity - 1;
+
+        struct Cell
+        {
+            std::atomic<size_t> sequence { 0 };
+            RealtimeJob* job = nullptr;
+        };
+
+        std::array<Cell, (size_t) queueCapacity> cells;
+        alignas(64) std::atomic<size_t> enqueuePos { 0 };
+        alignas(64) std::atomic<size_t> dequeuePos { 0 };
+    };
+
+    //==============================================================================
+    // Work-stealing deque (Chase-Lev, in the C11 formulation of Le et al.). The owning
+    // worker pushes and takes at the bottom; other workers steal from the top.
+    class StealingDeque
+    {
+    public:
+        bool push(RealtimeJob* job) noexcept
+        {
+            auto b = bottom.load(std::memory_order_relaxed);
+            auto t = top.load(std::memory_order_acquire);
+            if (b - t >= (juce::int64) queueCapacity)
+                return false;
+
+            slots[(size_t) (b & mask)].store(job, std::memory_order_release);
+            std::atomic_thread_fence(std::memory_order_release);
+            bottom.store(b + 1, std::memory_order_relaxed);
+            return true;
+        }
+
+        RealtimeJob* take() noexcept
+        {
+            auto b = bottom.load(std::memory_order_relaxed) - 1;
+            bottom.store(b, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            auto t = top.load(std::memory_order_relaxed);
+
+            RealtimeJob* job = nullptr;
+            if (t <= b)
+            {
+                job = slots[(size_t) (b & mask)].load(std::memory_order_relaxed);
+                if (t == b)
+                {
+                    // Last item: race any thief for it
+                    if (! top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+                        job = nullptr;
+                    bottom.store(b + 1, std::memory_order_relaxed);
+                }
+            }
+            else
+            {
+                bottom.store(b + 1, std::memory_order_relaxed);
+            }
+            return job;
+        }
+
+        RealtimeJob* steal() noexcept
+        {
+            auto t = top.load(std::memory_order_acquire);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            auto b = bottom.load(std::memory_order_acquire);
+
+            if (t >= b)
+                return nullptr;
+
+            auto* job = slots[(size_t) (t & mask)].load(std::memory_order_acquire);
+            if (! top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+                return nullptr;
+
+            return job;
+        }
+
+    private:
+        static constexpr juce::int64 mask = (juce::int64) queueCapacity - 1;
+
+        std::array<std::atomic<RealtimeJob*>, (size_t) queueCapacity> slots {};
+        alignas(64) std::atomic<juce::int64> top { 0 };
+        alignas(64) std::atomic<juce::int64> bottom { 0 };
+    };
+
+    //==============================================================================
+    class Worker : public juce::Thread
+    {
+    public:
+        Worker(RealtimeWorkerPool& p, int i)
+            : juce::Thread("Rack DSP worker " + juce::String(i)), pool(p), index(i) {}
+
+        void start()
+        {
+            // Fall back to a plain high-priority thread where real-time scheduling is refused
+            if (! startRealtimeThread(juce::Thread::RealtimeOptions{}.withPriority(8)))
+                startThread(juce::Thread::Priority::highest);
+        }
+
+        void run() override
+        {
+            const auto hotTicks = (juce::int64) (hotSeconds * (double) juce::Time::getHighResolutionTicksPerSecond());
+            auto lastJobTicks = juce::Time::getHighResolutionTicks();
+
+            while (! threadShouldExit())
+            {
+                if (auto* job = findJob())
+                {
+                    pool.execute(*job);
+                    lastJobTicks = juce::Time::getHighResolutionTicks();
+                    continue;
+                }
+
+                // Stay hot while the callbacks are still submitting, then park until a submit
+                if (juce::Time::getHighResolutionTicks() - lastJobTicks < hotTicks)
+                {
+                    juce::Thread::yield();
+                    continue;
+                }
+
+                pool.park();
+                lastJobTicks = juce::Time::getHighResolutionTicks();
+            }
+        }
+
+        StealingDeque deque;
+
+    private:
+        RealtimeJob* findJob()
+        {
+            if (auto* job = deque.take())
+                return job;
+
+            // Take a small batch from the injection queue; the spares become stealable
+            if (auto* job = pool.injection.pop())
+            {
+                for (int i = 0; i < batchSize - 1; ++i)
+                {
+                    auto* spare = pool.injection.pop();
+                    if (spare == nullptr)
+                        break;
+                    if (! deque.push(spare))
+                    {
+                        pool.execute(*spare);
+                        break;
+                    }
+                }
+                return job;
+            }
+
+            for (size_t i = 1; i < pool.workers.size(); ++i)
+                if (auto* job = pool.workers[((size_t) index + i) % pool.workers.size()]->deque.steal())
+                    return job;
+
+            return nullptr;
+        }
+
+        static constexpr int batchSize = 4;
+        static constexpr double hotSeconds = 0.002;
+
+        RealtimeWorkerPool& pool;
+        int index;
+    };
+
+    //==============================================================================
+    // A parked worker counts itself in, then looks at the queue once more, so a job
+    // pushed in between either is seen here or finds it counted and posts
+    void park()
+    {
+        parked.fetch_add(1, std::memory_order_seq_cst);
+
+        if (! injection.isEmpty() && unpark())
+            return;
+
+        wakeSignal.wait();
+    }
+
+    // Takes one parked worker off the count; false if every one is already being woken
+    bool unpark() noexcept
+    {
+        auto n = parked.load(std::memory_order_seq_cst);
+        while (n > 0 && ! parked.compare_exchange_weak(n, n - 1, std::memory_order_seq_cst)) {}
+        return n > 0;
+    }
+
+    void wakeOne() noexcept
+    {
+        if (unpark())
+            wakeSignal.post();
+    }
+
+    void execute(RealtimeJob& job)
+    {
+        int expected = RealtimeJob::queued;
+        if (! job.state.compare_exchange_strong(expected, RealtimeJob::running, std::memory_order_acq_rel))
+            return;
+
+        // Work picked up too late is worthless to the audio thread; skip it
+        if (juce::Time::getHighResolutionTicks() > job.deadlineTicks)
+        {
+            job.state.store(RealtimeJob::expired, std::memory_order_release);
+            return;
+        }
+
+        job.run();
+        job.state.store(RealtimeJob::finished, std::memory_order_release);
+    }
+
+    std::vector<std::unique_ptr<Worker>> workers;
+    InjectionQueue injection;
+    WakeSignal wakeSignal;
+    std::atomic<int> parked { 0 };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (RealtimeWorkerPool)
+};
@@ -0,0 +1,126 @@
+/*
+  ==============================================================================
+
+    ScratchArena.h
+    One aligned allocation per instance that hands out the chain's working
+    buffers. Each region is reserved with the span of stages it is live for;
+    regions whose spans never overlap are packed into the same memory.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+class ScratchArena
+{
+public:
+    using Handle = int;
+
+    static constexpr int persistent = std::numeric_limits<int>::max(); // Live across blocks
+    static constexpr size_t alignment = 64;                            // Bytes; one cache line
+
+    ScratchArena() {}
+    ~ScratchArena() {}
+
+    // Starts a new plan. Pointers from the previous plan become invalid after allocate().
+    void beginPlan()
+    {
+        regions.clear();
+    }
+
+    // Reserves numFloats that are live from stage firstStage to lastStage inclusive.
+    // Pass persistent as lastStage for state that must survive between blocks.
+    Handle reserve(size_t numFloats, int firstStage, int lastStage)
+    {
+        Region r;
+        r.numFloats = roundUp(juce::jmax((size_t) 1, numFloats));
+        r.firstStage = lastStage == persistent ? 0 : firstStage;
+        r.lastStage = lastStage;
+        regions.push_back(r);
+        return (Handle) regions.size() - 1;
+    }
+
+    // Places every region and makes the single allocation. Call from prepareToPlay only.
+    void allocate()
+    {
+        // Largest first, each at the lowest offset not used by a region it is live alongside
+        std::vector<size_t> order(regions.size());
+        for (size_t i = 0; i < order.size(); ++i)
+            order[i] = i;
+        std::stable_sort(order.begin(), order.end(),
+                         [this](size_t a, size_t b) { return regions[a].numFloats > regions[b].numFloats; });
+
+        std::vector<size_t> placed;
+        size_t total = 0;
+
+        for (auto index : order)
+        {
+            auto& r = regions[index];
+            size_t offset = 0;
+
+            for (bool moved = true; moved;)
+            {
+                moved = false;
+                for (auto other : placed)
+                {
+                    const auto& o = regions[other];
+                    bool liveTogether = r.firstStage <= o.lastStage && o.firstStage <= r.lastStage;
+                    bool overlaps = offset < o.offset + o.numFloats && o.offset < offset + r.numFloats;
+
+                    if (liveTogether && overlaps)
+                    {
+                        offset = o.offset + o.numFloats;
+                        moved = true;
+                    }
+                }
+            }
+
+            r.offset = offset;
+            total = juce::jmax(total, offset + r.numFloats);
+            placed.push_back(index);
+        }
+
+        const size_t padding = alignment / sizeof(float);
+        memory.reset(new float[total + padding]());
+
+        auto address = reinterpret_cast<std::uintptr_t>(memory.get());
+        base = memory.get() + (((alignment - address % alignment) % alignment) / sizeof(float));
+        footprintFloats = total;
+    }
+
+    float* get(Handle handle) const { return base + regions[(size_t) handle].offset; }
+
+    // Bytes actually allocated, and what the same buffers would cost unshared
+    size_t getFootprintBytes() const { return footprintFloats * sizeof(float); }
+    size_t getRequestedBytes() const
+    {
+        size_t sum = 0;
+        for (const auto& r : regions)
+            sum += r.numFloats;
+        return sum * sizeof(float);
+    }
+
+private:
+    struct Region
+    {
+        size_t numFloats = 0;
+        size_t offset = 0;
+        int firstStage = 0;
+        int lastStage = 0;
+    };
+
+    static size_t roundUp(size_t numFloats)
+    {
+        const size_t floatsPerLine = alignment / sizeof(float);
+        return (numFloats + floatsPerLine - 1) / floatsPerLine * floatsPerLine;
+    }
+
+    std::vector<Region> regions;
+    std::unique_ptr<float[]> memory;
+    float* base = nullptr;
+    size_t footprintFloats = 0;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ScratchArena)
+};
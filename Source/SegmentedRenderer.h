@@ -0,0 +1,287 @@
+/*
+  ==============================================================================
+
+    SegmentedRenderer.h
+    Offline render of one long take on every core. The file is cut into
+    block-aligned segments, each rendered by its own RackEngine on a thread
+    pool, and the kept parts are written straight into the output.
+
+    The block-stepped smoothing (the detector's intensity, density and
+    timbre, and Space's wet level) settles far too slowly to warm up: it
+    would take minutes of audio before every cut. So the detector runs once,
+    serially, over the whole take first. It records every block's outputs,
+    and Space's wet smoothing as it stands at each segment's start. The
+    segments take their pressure and pitch from those snapshots and start
+    Space from that state, so none of it needs a warm-up.
+
+    What still warms up, over the audio before each cut, is the chain: its
+    latency, the doubler's delay lines, the reverb's decay and, in Match
+    Input mode, the makeup's 3 s loudness window. Ahead of that the
+    detector replays a few snapshots so the stages that hear the audio late
+    have its history, and its transient lane settles. Tolerance is the
+    largest remaining fraction of the transient envelopes' initial error.
+
+    The serial pass doesn't see the silence gate, which stops a live
+    detector while the chain is idle, so after a long silence the pressure
+    can differ from a serial render's until the smoothing catches up.
+    The reverb's parameters only follow changes past their thresholds, so
+    they can also differ by up to those. The renderer can run the serial
+    render to measure the peak difference and the real speed-up.
+
+    Makeup in Target mode follows the integrated loudness of everything
+    since the start, which no warm-up can reproduce, so those renders run
+    as one segment.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "RackEngine.h"
+
+class SegmentedRenderer
+{
+public:
+    struct Options
+    {
+        int blockSize = 512;            // Also the serial render's block size; the detector is block-rate
+        int numSegments = 0;            // 0: one per CPU core
+        float tolerance = 1.0e-3f;      // Remaining error of the transient lane at each cut
+        bool monoInput = false;         // Input channel 0 only, rendered as the plugin's mono-in/stereo-out
+        bool verifyAgainstSerial = false;
+    };
+
+    struct Report
+    {
+        int numSegments = 0;
+        double analysisSeconds = 0.0;     // The serial detector pass
+        double chainWarmUpSeconds = 0.0;  // Of audio, per segment
+        double wallSeconds = 0.0;         // Including the serial pass
+        double serialSeconds = 0.0;       // The serial render, if verified
+        double speedUp = 0.0;             // serialSeconds / wallSeconds, if verified
+        float maxDifference = 0.0f;       // Peak |segmented - serial|, if verified
+    };
+
+    explicit SegmentedRenderer(const Options& optionsToUse) : options(optionsToUse) {}
+    ~SegmentedRenderer() {}
+
+    // Renders input into a stereo output of the same length
+    Report render(const juce::AudioBuffer<float>& input, juce::AudioBuffer<float>& output, double sampleRate,
+                  const RackSettings& settings, const RackChain::Switches& switches = {})
+    {
+        const int length = input.getNumSamples();
+        const int blockSize = options.blockSize;
+        output.setSize(2, length, false, false, true);
+
+        Report report;
+        const bool canSegment = settings.makeupMode != (int) MakeupGainModule::Mode::target;
+        const int numBlocks = (length + blockSize - 1) / blockSize;
+        const int requested = options.numSegments > 0 ? options.numSegments : juce::SystemStats::getNumCpus();
+        report.numSegments = canSegment ? juce::jlimit(1, juce::jmax(1, numBlocks), requested) : 1;
+
+        // A throwaway engine reports the chain's latency, delay lines and reverb decay
+        RackEngine probe;
+        probe.prepare(sampleRate, blockSize, 1, options.monoInput);
+        probe.setStreamSettings(0, settings, switches);
+
+        const int chainBlocks = chainWarmUpBlocks(probe.getChain(0), sampleRate, settings, switches);
+        const int primeBlocks = primingBlocks(probe.getLatencySamples(), sampleRate);
+        report.chainWarmUpSeconds = chainBlocks * (double) blockSize / sampleRate;
+
+        // Cuts on the block grid, so each segment sees the serial render's blocks
+        std::vector<Segment> segments ((size_t) report.numSegments);
+        for (int i = 0; i < report.numSegments; ++i)
+        {
+            auto& segment = segments[(size_t) i];
+            segment.begin = (int) ((juce::int64) numBlocks * i / report.numSegments) * blockSize;
+            segment.end = juce::jmin(length, (int) ((juce::int64) numBlocks * (i + 1) / report.numSegments) * blockSize);
+            segment.chainStart = juce::jmax(0, segment.begin - chainBlocks * blockSize);
+        }
+
+        auto startTime = juce::Time::getMillisecondCounterHiRes();
+        const auto snapshots = analyseSerially(input, sampleRate, settings, switches, probe.getLatencySamples(), segments);
+        report.analysisSeconds = (juce::Time::getMillisecondCounterHiRes() - startTime) * 0.001;
+
+        {
+            juce::ThreadPool pool (juce::jmin(report.numSegments, juce::SystemStats::getNumCpus()));
+            std::atomic<int> remaining { report.numSegments };
+            juce::WaitableEvent finished;
+
+            for (const auto& segment : segments)
+            {
+                pool.addJob([&, segment]
+                {
+                    renderSegment(input, output, sampleRate, settings, switches, segment, primeBlocks, &snapshots);
+                    if (--remaining == 0)
+                        finished.signal();
+                });
+            }
+
+            finished.wait(-1);
+        }
+        report.wallSeconds = (juce::Time::getMillisecondCounterHiRes() - startTime) * 0.001;
+
+        if (options.verifyAgainstSerial)
+        {
+            // A fully live render, as the plugin would run it
+            juce::AudioBuffer<float> serial (2, length);
+            Segment whole;
+            whole.end = length;
+
+            auto serialStart = juce::Time::getMillisecondCounterHiRes();
+            renderSegment(input, serial, sampleRate, settings, switches, whole, 0, nullptr);
+            report.serialSeconds = (juce::Time::getMillisecondCounterHiRes() - serialStart) * 0.001;
+            report.speedUp = report.wallSeconds > 0.0 ? report.serialSeconds / report.wallSeconds : 0.0;
+
+            for (int channel = 0; channel < 2; ++channel)
+                for (int i = 0; i < length; ++i)
+                    report.maxDifference = juce::jmax(report.maxDifference, std::abs(output.getSample(channel, i) - serial.getSample(channel, i)));
+        }
+
+        return report;
+    }
+
+private:
+    struct Segment
+    {
+        int begin = 0, end = 0;   // The kept part
+        int chainStart = 0;       // Where the chain's warm-up starts
+        juce::LinearSmoothedValue<float> wet { 0.0f }; // Space's wet smoothing at chainStart
+    };
+
+    int chainWarmUpBlocks(const RackChain& chain, double sampleRate, const RackSettings& settings,
+                          const RackChain::Switches& switches) const
+    {
+        double seconds = chain.getRingSamples() / sampleRate;
+        if (switches.space)
+            seconds += chain.getReverbTailSeconds();
+        if (settings.makeupMode == (int) MakeupGainModule::Mode::matchInput)
+            seconds += 3.3; // Short-term loudness window plus the gain smoothing
+
+        return (int) std::ceil(seconds * sampleRate / options.blockSize);
+    }
+
+    // Snapshots replayed into the detector alone before the chain starts: enough history
+    // for the stages that hear the audio latency samples late, and for the transient
+    // lane's slowest envelope to settle within the tolerance
+    int primingBlocks(int latency, double sampleRate) const
+    {
+        const double transientSeconds = -std::log((double) options.tolerance) * TransientDetector::slowReleaseMs * 0.001;
+        const int historyBlocks = (latency + options.blockSize / 2) / options.blockSize + 1;
+        return juce::jmax(historyBlocks, (int) std::ceil(transientSeconds * sampleRate / options.blockSize));
+    }
+
+    // The serial pass: a live detector over the block grid, as the serial render runs it.
+    // Returns every block's outputs, and stores Space's wet smoothing at each chainStart.
+    std::vector<PressureDetector::Snapshot> analyseSerially(const juce::AudioBuffer<float>& input, double sampleRate,
+                                                           const RackSettings& settings, const RackChain::Switches& switches,
+                                                           int latency, std::vector<Segment>& segments) const
+    {
+        const int blockSize = options.blockSize;
+        const int length = input.getNumSamples();
+        const int numChannels = options.monoInput ? 1 : 2;
+        const int inputChannels = juce::jmin(numChannels, input.getNumChannels());
+
+        juce::dsp::ProcessSpec spec;
+        spec.sampleRate = sampleRate;
+        spec.maximumBlockSize = (juce::uint32) blockSize;
+        spec.numChannels = (juce::uint32) numChannels;
+
+        PressureDetector detector, afterTame;
+        detector.prepare(spec);
+        detector.setUseWorkerPool(false);
+        std::vector<float> scratch (PressureDetector::getScratchSize(spec));
+        detector.setScratch(scratch.data());
+
+        // Space hears the audio late by the spectral stages' latency, as in the chain
+        SpaceModule space;
+        space.prepare(spec);
+        space.mixAmount = settings.spaceMix;
+        space.characterAmount = settings.spaceCharacter;
+
+        std::vector<PressureDetector::Snapshot> snapshots;
+        snapshots.reserve((size_t) ((length + blockSize - 1) / blockSize));
+        juce::AudioBuffer<float> work (numChannels, blockSize);
+        work.clear();
+
+        auto next = segments.begin();
+        for (int position = 0; position < length; position += blockSize)
+        {
+            for (; next != segments.end() && next->chainStart == position; ++next)
+                next->wet = space.getWetSmoothing();
+
+            const int numSamples = juce::jmin(blockSize, length - position);
+            juce::AudioBuffer<float> block (work.getArrayOfWritePointers(), numChannels, numSamples);
+            for (int channel = 0; channel < inputChannels; ++channel)
+                block.copyFrom(channel, 0, input, channel, position, numSamples);
+
+            detector.process(block);
+            snapshots.push_back(detector.getSnapshot());
+
+            if (switches.space)
+            {
+                if (latency > 0)
+                    afterTame.followDelayed(detector, latency);
+                space.advanceWet(latency > 0 ? afterTame : detector);
+            }
+        }
+
+        return snapshots;
+    }
+
+    // Renders the segment's kept part after warming the chain up over the blocks before
+    // it. Without snapshots the detector runs live, from the start of the take.
+    void renderSegment(const juce::AudioBuffer<float>& input, juce::AudioBuffer<float>& output, double sampleRate,
+                       const RackSettings& settings, const RackChain::Switches& switches, const Segment& segment,
+                       int primeBlocks, const std::vector<PressureDetector::Snapshot>* snapshots) const
+    {
+        const int blockSize = options.blockSize;
+        const int primeStart = juce::jmax(0, segment.chainStart - primeBlocks * blockSize);
+
+        RackEngine engine;
+        engine.prepare(sampleRate, blockSize, 1, options.monoInput);
+        engine.setStreamSettings(0, settings, switches);
+
+        juce::AudioBuffer<float> work (2, blockSize);
+        const int inputChannels = options.monoInput ? 1 : juce::jmin(2, input.getNumChannels());
+
+        // Fills work from position; returns the block's length
+        auto readBlock = [&](int position)
+        {
+            const int numSamples = juce::jmin(blockSize, input.getNumSamples() - position);
+            work.clear();
+            for (int channel = 0; channel < inputChannels; ++channel)
+                work.copyFrom(channel, 0, input, channel, position, numSamples);
+            return numSamples;
+        };
+
+        if (snapshots != nullptr)
+        {
+            for (int position = primeStart; position < segment.chainStart; position += blockSize)
+            {
+                juce::AudioBuffer<float> block (work.getArrayOfWritePointers(), 2, readBlock(position));
+                engine.analyse(0, block, (*snapshots)[(size_t) (position / blockSize)]);
+            }
+
+            engine.getChain(0).getSpace().setWetSmoothing(segment.wet);
+        }
+
+        for (int position = segment.chainStart; position < segment.end; position += blockSize)
+        {
+            juce::AudioBuffer<float> block (work.getArrayOfWritePointers(), 2, readBlock(position));
+
+            if (snapshots != nullptr)
+                engine.process(0, block, (*snapshots)[(size_t) (position / blockSize)]);
+            else
+                engine.process(0, block);
+
+            if (position >= segment.begin)
+                for (int channel = 0; channel < 2; ++channel)
+                    output.copyFrom(channel, position, block, channel, 0, block.getNumSamples());
+        }
+    }
+
+    Options options;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (SegmentedRenderer)
+};
@@ -22,8 +22,36 @@ void ShiftModule::prepare(const juce::dsp::ProcessSpec& spec)
 {
     sampleRate = spec.sampleRate;
     delayLines.resize(spec.numChannels);
-    for (auto& dl : delayLines)
-        dl.setup(8192);
+
+    // Longest double sits at ~40 ms with up to 5 ms of wander on top
+    doublerBank.assign((size_t) juce::nextPowerOfTwo((int) (sampleRate * 0.05) + 4), 0.0f);
+    doublerMask = (int) doublerBank.size() - 1;
+    doublerWritePos = 0;
+    controlCounter = 0;
+    controlRate = sampleRate / controlInterval;
+    doublerSounding = false;
+
+    ratioState.invalidate();
+
+    // Voices start silent at their home offsets and fade in from there
+    for (auto* state : { &voiceDelayStep, &voiceDriftTarget, &voiceDriftStage, &voiceDrift,
+                         &voiceGainL, &voiceGainR, &voiceGainStepL, &voiceGainStepR })
+        state->fill(0.0f);
+    voiceHoldTicks.fill(0);
+
+    for (int v = 0; v < maxVoices; ++v)
+    {
+        // Rates spread log-evenly, so no two voices drift in step
+        voiceDriftRateHz[(size_t) v] = 0.1f * std::pow(24.0f, (float) v / (float) (maxVoices - 1));
+        voiceDriftCoeff[(size_t) v] = 1.0f - std::exp(-juce::MathConstants<float>::twoPi * voiceDriftRateHz[(size_t) v] / (float) controlRate);
+        voiceDelay[(size_t) v] = getDoublerHomeMs(v) * (float) (sampleRate * 0.001);
+    }
+}
+
+void ShiftModule::setScratch(float* memory)
+{
+    for (size_t channel = 0; channel < delayLines.size(); ++channel)
+        delayLines[channel].setup(memory + channel * delayLineSize);
 }
 
 void ShiftModule::process(juce::AudioBuffer<float>& buffer, const PressureDetector& detector)
@@ -33,12 +61,20 @@ void ShiftModule::process(juce::AudioBuffer<float>& buffer, const PressureDetect
     // The "Demonic Bloom": The shift module reacts to the performance.
     // We set a base formant shift, and as intensity increases, it "blooms" further down (demonic).
     // The README mentions a specific -5 semitone bloom target on screams.
-    float bloomAmount = intensity * 5.0f;
-    float dynamicFormant = formantShift - bloomAmount;
-    float dynamicPitch = pitchShift;
+    // High screams bloom further than low growls, as far as the pitch tracker is sure of the register.
+    if (ratioState.needsUpdate({ pitchShift, formantShift, intensity, detector.getPitchHz(), detector.getPitchConfidence() }))
+    {
+        float register01 = 0.0f;
+        if (detector.getPitchHz() > 0.0f)
+            register01 = juce::jlimit(0.0f, 1.0f, std::log2(detector.getPitchHz() / 110.0f) / 3.0f) * detector.getPitchConfidence();
 
-    // Map semitones to ratio
-    float ratio = std::pow(2.0f, (dynamicPitch + dynamicFormant) / 12.0f);
+        float bloomAmount = intensity * 5.0f * (1.0f + 0.4f * register01);
+        float dynamicFormant = formantShift - bloomAmount;
+        float dynamicPitch = pitchShift;
+
+        // Map semitones to ratio
+        ratio = std::pow(2.0f, (dynamicPitch + dynamicFormant) / 12.0f);
+    }
 
     // We use a small delay range to keep it "unstable" and gritty as requested.
     float delayRange = 400.0f; // samples
@@ -64,4 +100,128 @@ void ShiftModule::process(juce::AudioBuffer<float>& buffer, const PressureDetect
             buffer.setSample(channel, sample, output);
         }
     }
+
+    // Keeps running after the voices are switched off until they have faded out
+    if (doublerVoices > 0 && ! doublerSounding)
+        std::fill(doublerBank.begin(), doublerBank.end(), 0.0f);
+
+    if (doublerVoices > 0 || doublerSounding)
+        renderDoubles(buffer);
+}
+
+void ShiftModule::updateDoublerModulators()
+{
+    const float msToSamples = (float) (sampleRate * 0.001);
+    const float wanderMs = 1.0f + doublerSpread * 4.0f;
+
+    // A delay changing by d samples per sample detunes by a factor of (1 - d), so the
+    // slew bound is the detune bound: 2 cents at no spread, 6 at full spread
+    const float maxDetuneCents = 2.0f + doublerSpread * 4.0f;
+    const float maxDelayChange = (std::pow(2.0f, maxDetuneCents / 1200.0f) - 1.0f) * (float) controlInterval;
+
+    const float gainCoeff = 1.0f - std::exp(-(float) controlInterval / (gainRampSeconds * (float) sampleRate));
+    const float level = doublerVoices > 0 ? 0.8f / std::sqrt((float) doublerVoices) : 0.0f;
+    const float silent = 1.0e-4f;
+
+    doublerSounding = false;
+
+    for (int v = 0; v < maxVoices; ++v)
+    {
+        const auto i = (size_t) v;
+
+        if (--voiceHoldTicks[i] <= 0)
+        {
+            voiceDriftTarget[i] = doublerRandom.nextFloat() * 2.0f - 1.0f;
+            voiceHoldTicks[i] = juce::jmax(1, (int) (controlRate / voiceDriftRateHz[i] * (0.5f + doublerRandom.nextFloat())));
+        }
+
+        voiceDriftStage[i] += voiceDriftCoeff[i] * (voiceDriftTarget[i] - voiceDriftStage[i]);
+        voiceDrift[i]      += voiceDriftCoeff[i] * (voiceDriftStage[i] - voiceDrift[i]);
+
+        const float target = (getDoublerHomeMs(v) + voiceDrift[i] * wanderMs) * msToSamples;
+        const bool active = v < doublerVoices;
+
+        // A silent voice waits at its target, so it comes in without sweeping
+        if (! active && voiceGainL[i] == 0.0f && voiceGainR[i] == 0.0f)
+        {
+            voiceDelay[i] = target;
+            voiceDelayStep[i] = 0.0f;
+            voiceGainStepL[i] = voiceGainStepR[i] = 0.0f;
+            continue;
+        }
+
+        voiceDelayStep[i] = juce::jlimit(-maxDelayChange, maxDelayChange, target - voiceDelay[i]) / (float) controlInterval;
+
+        // Alternate sides, spreading further out with each voice; gains glide to their
+        // targets so voice count and spread changes don't click
+        const float pan = (v % 2 == 0 ? 1.0f : -1.0f) * doublerSpread * (0.3f + 0.7f * (float) (v + 1) / (float) maxVoices);
+        const float targetL = active ? std::sqrt(0.5f * (1.0f - pan)) * level : 0.0f;
+        const float targetR = active ? std::sqrt(0.5f * (1.0f + pan)) * level : 0.0f;
+
+        if (! active && voiceGainL[i] < silent && voiceGainR[i] < silent)
+        {
+            voiceGainL[i] = voiceGainR[i] = 0.0f;
+            voiceGainStepL[i] = voiceGainStepR[i] = 0.0f;
+            continue;
+        }
+
+        voiceGainStepL[i] = gainCoeff * (targetL - voiceGainL[i]) / (float) controlInterval;
+        voiceGainStepR[i] = gainCoeff * (targetR - voiceGainR[i]) / (float) controlInterval;
+        doublerSounding = true;
+    }
+}
+
+void ShiftModule::renderDoubles(juce::AudioBuffer<float>& buffer)
+{
+    const int numChannels = juce::jmin(buffer.getNumChannels(), 2);
+    if (numChannels == 0)
+        return;
+
+    auto* left  = buffer.getWritePointer(0);
+    auto* right = buffer.getWritePointer(numChannels - 1);
+
+    const float* bank = doublerBank.data();
+
+    for (int sample = 0; sample < buffer.getNumSamples(); ++sample)
+    {
+        if (controlCounter == 0)
+            updateDoublerModulators();
+        controlCounter = (controlCounter + 1) % controlInterval;
+
+        float input = numChannels > 1 ? (left[sample] + right[sample]) * 0.5f : left[sample];
+        doublerBank[(size_t) doublerWritePos] = input;
+
+        // One pass over every voice slot; silent slots just carry zero gain
+        for (int v = 0; v < maxVoices; ++v)
+        {
+            float readPos = (float) doublerWritePos - voiceDelay[(size_t) v];
+            int i0 = (int) std::floor(readPos);
+            float frac = readPos - (float) i0;
+            float a = bank[i0 & doublerMask];
+            float b = bank[(i0 + 1) & doublerMask];
+            voiceOut[(size_t) v] = a + (b - a) * frac;
+            voiceDelay[(size_t) v] += voiceDelayStep[(size_t) v];
+        }
+
+        float sumL = 0.0f, sumR = 0.0f;
+        for (int v = 0; v < maxVoices; ++v)
+        {
+            sumL += voiceOut[(size_t) v] * voiceGainL[(size_t) v];
+            sumR += voiceOut[(size_t) v] * voiceGainR[(size_t) v];
+            voiceGainL[(size_t) v] += voiceGainStepL[(size_t) v];
+            voiceGainR[(size_t) v] += voiceGainStepR[(size_t) v];
+        }
+
+        doublerWritePos = (doublerWritePos + 1) & doublerMask;
+
+        if (numChannels > 1)
+        {
+            left[sample]  += sumL;
+            right[sample] += sumR;
+        }
+        else
+        {
+            left[sample] += (sumL + sumR) * 0.5f;
+        }
+    }
 }
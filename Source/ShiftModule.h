@@ -12,6 +12,7 @@
 
 #include <JuceHeader.h>
 #include "PressureDetector.h"
+#include "DerivedState.h"
 
 class ShiftModule
 {
@@ -22,37 +23,97 @@ public:
     void prepare(const juce::dsp::ProcessSpec& spec);
     void process(juce::AudioBuffer<float>& buffer, const PressureDetector& detector);
 
+    // Shifter delay lines, from the owner's ScratchArena (persistent across blocks)
+    static size_t getScratchSize(const juce::dsp::ProcessSpec& spec) { return (size_t) spec.numChannels * delayLineSize; }
+    void setScratch(float* memory);
+
+    // Longest a sample can sit in the shifter or doubler delays before it has left the output
+    int getTailSamples() const { return juce::jmax(delayLineSize, (int) doublerBank.size()); }
+
+    // Shift ratio updates since construction, for the telemetry
+    juce::uint32 getRecomputeCount() const { return ratioState.getRecomputeCount(); }
+
     float pitchShift = 0.0f; // -12 to +12
     float formantShift = 0.0f; // -12 to +12
 
+    // Doubler / thickener: 0 = off, otherwise the number of detuned, time-offset voices
+    static constexpr int maxVoices = 8;
+    int doublerVoices = 0;
+    float doublerSpread = 0.5f; // 0.0 to 1.0, widens time offsets, detune and panning
+
 private:
     double sampleRate = 44100.0;
 
+    // Ratio depends on pitch/formant shift, intensity bloom and the sung register;
+    // thresholds keep each input's effect on the ratio under ~0.015 semitones
+    DerivedState<5> ratioState { { 0.01f, 0.01f, 0.002f, 0.5f, 0.005f } };
+    float ratio = 1.0f;
+
+    void renderDoubles(juce::AudioBuffer<float>& buffer);
+    void updateDoublerModulators();
+    float getDoublerHomeMs(int voice) const { return 8.0f + (float) voice * (2.0f + doublerSpread * 2.5f); }
+
+    // All doubles read one shared fractional delay bank. Per-voice state is laid out
+    // struct-of-arrays so the voice loop runs as one vectorisable pass per sample.
+    static constexpr int controlInterval = 32; // Drift and gains update at control rate
+    static constexpr float gainRampSeconds = 0.02f;
+
+    std::vector<float> doublerBank;
+    int doublerMask = 0;
+    int doublerWritePos = 0;
+    int controlCounter = 0;
+    double controlRate = 44100.0 / controlInterval;
+    bool doublerSounding = false; // Any voice still has gain, including ones fading out
+
+    // Each voice drifts around its home offset: random targets, held for about one
+    // period of the voice's drift rate (0.1 to 2.4 Hz), through two one-pole low-passes.
+    // The delay follows at a bounded slew, so the pitch never moves more than a few cents.
+    alignas(32) std::array<float, maxVoices> voiceDelay {};       // Current delay in samples
+    alignas(32) std::array<float, maxVoices> voiceDelayStep {};   // Per-sample delay ramp
+    alignas(32) std::array<float, maxVoices> voiceDriftTarget {}; // Held random target, -1 to 1
+    alignas(32) std::array<float, maxVoices> voiceDriftStage {};  // First low-pass
+    alignas(32) std::array<float, maxVoices> voiceDrift {};       // Second low-pass, -1 to 1
+    alignas(32) std::array<float, maxVoices> voiceDriftCoeff {};
+    alignas(32) std::array<float, maxVoices> voiceDriftRateHz {};
+    alignas(32) std::array<float, maxVoices> voiceGainL {};
+    alignas(32) std::array<float, maxVoices> voiceGainR {};
+    alignas(32) std::array<float, maxVoices> voiceGainStepL {};   // Per-sample gain ramps
+    alignas(32) std::array<float, maxVoices> voiceGainStepR {};
+    alignas(32) std::array<float, maxVoices> voiceOut {};
+    std::array<int, maxVoices> voiceHoldTicks {};
+
+    juce::Random doublerRandom { 0x5eed };
+
+    // Taps never reach further back than the 400-sample shifter window
+    static constexpr int delayLineSize = 512;
+
     // A simple delay-line based pitch shifter for "weirdness"
     struct DelayLine {
-        juce::AudioBuffer<float> buffer;
+        float* data = nullptr;
         int writePos = 0;
-        float readPos = 0.0f;
 
-        void setup(int size) {
-            buffer.setSize(1, size);
-            buffer.clear();
+        void setup(float* memory) {
+            data = memory;
+            std::fill(data, data + delayLineSize, 0.0f);
+            writePos = 0;
         }
 
         void write(float sample) {
-            buffer.setSample(0, writePos, sample);
-            writePos = (writePos + 1) % buffer.getNumSamples();
+            data[writePos] = sample;
+            writePos = (writePos + 1) & (delayLineSize - 1);
         }
 
-        float read(float offset) {
-            float pos = (float)writePos - offset;
-            while (pos < 0) pos += (float)buffer.getNumSamples();
+        // offset 0 is the newest sample; taps stay between it and the one offset back,
+        // never wrapping onto the oldest slot that writePos points at
+        float read(float offset) const {
+            float pos = (float)(writePos - 1) - offset;
+            while (pos < 0) pos += (float)delayLineSize;
 
-            int i1 = (int)pos % buffer.getNumSamples();
-            int i2 = (i1 + 1) % buffer.getNumSamples();
+            int i1 = (int)pos & (delayLineSize - 1);
+            int i2 = (i1 + 1) & (delayLineSize - 1);
             float frac = pos - (float)((int)pos);
 
-            return buffer.getSample(0, i1) * (1.0f - frac) + buffer.getSample(0, i2) * frac;
+            return data[i1] * (1.0f - frac) + data[i2] * frac;
         }
     };
 
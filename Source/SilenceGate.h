@@ -0,0 +1,76 @@
+/*
+  ==============================================================================
+
+    SilenceGate.h
+    Block-level silence detection for the whole chain. Once the input has
+    been silent long enough for everything in flight to reach the output,
+    and the output itself has decayed below the threshold, the chain is
+    idle and the owner can skip it and write zeros until signal returns.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+class SilenceGate
+{
+public:
+    static constexpr float threshold = 1.5849e-5f; // -96 dBFS, block peak
+
+    SilenceGate() {}
+    ~SilenceGate() {}
+
+    // flushSamples covers the pure delays (latency, delay lines) that can hold
+    // signal without it showing at the output yet
+    void prepare(int flushSamples)
+    {
+        flushLength = juce::jmax(0, flushSamples);
+        reset();
+    }
+
+    void reset()
+    {
+        silentInputSamples = 0;
+        idle = false;
+    }
+
+    // Call on the input before processing. Returns false when the chain can be skipped.
+    bool shouldProcess(const juce::AudioBuffer<float>& input)
+    {
+        if (! isSilent(input))
+        {
+            silentInputSamples = 0;
+            idle = false;
+            return true;
+        }
+
+        silentInputSamples = juce::jmin(silentInputSamples + input.getNumSamples(), std::numeric_limits<int>::max() / 2);
+        return ! idle;
+    }
+
+    // Call on the output after processing. Reverb and filter tails keep the chain
+    // running for as long as they are audible at the output.
+    void outputProcessed(const juce::AudioBuffer<float>& output)
+    {
+        idle = silentInputSamples > flushLength && isSilent(output);
+    }
+
+    bool isIdle() const { return idle; }
+
+private:
+    static bool isSilent(const juce::AudioBuffer<float>& buffer)
+    {
+        for (int channel = 0; channel < buffer.getNumChannels(); ++channel)
+            if (buffer.getMagnitude(channel, 0, buffer.getNumSamples()) >= threshold)
+                return false;
+        return true;
+    }
+
+    int flushLength = 0;
+    int silentInputSamples = 0;
+    bool idle = false;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (SilenceGate)
+};
@@ -22,45 +22,71 @@ void SpaceModule::prepare(const juce::dsp::ProcessSpec& spec)
 {
     sampleRate = spec.sampleRate;
     reverb.setSampleRate(sampleRate);
-    smoothedWet.reset(sampleRate, 0.05);
+    smoothedWet.reset(sampleRate, wetSmoothingSeconds);
+    reverbState.invalidate();
 }
 
-void SpaceModule::process(juce::AudioBuffer<float>& buffer, const PressureDetector& detector)
+float SpaceModule::getTailSeconds() const
 {
-    float intensity = detector.getIntensity();
+    float morph = characterAmount < 0.5f ? characterAmount * 2.0f : (characterAmount - 0.5f) * 2.0f;
+    float roomSize = characterAmount < 0.5f ? 0.1f * (1.0f - morph) + 0.6f * morph
+                                            : 0.6f * (1.0f - morph) + 1.0f * morph;
+    roomSize = juce::jlimit(0.0f, 1.0f, roomSize + characterAmount * 0.5f);
 
-    // Reverb parameters morphing: Room -> Plate -> Bloom
-    juce::Reverb::Parameters params;
+    // juce::Reverb is a Freeverb: the longest comb (1617 samples at 44.1 kHz) loops
+    // with feedback roomSize * 0.28 + 0.7, which sets the low-frequency decay
+    const float loopSeconds = 1617.0f / 44100.0f;
+    const float feedback = roomSize * 0.28f + 0.7f;
+    return loopSeconds * -3.0f / std::log10(feedback);
+}
 
+float SpaceModule::advanceWet(const PressureDetector& detector)
+{
+    float intensity = detector.getIntensity();
     float bloom = characterAmount * intensity; // Explosive growth when loud and char is high
 
-    if (characterAmount < 0.5f) // Room towards Plate
-    {
-        float morph = characterAmount * 2.0f;
-        params.roomSize = 0.1f * (1.0f - morph) + 0.6f * morph;
-        params.damping = 0.8f * (1.0f - morph) + 0.3f * morph;
-    }
-    else // Plate towards Bloom
-    {
-        float morph = (characterAmount - 0.5f) * 2.0f;
-        params.roomSize = 0.6f * (1.0f - morph) + 1.0f * morph;
-        params.damping = 0.3f * (1.0f - morph) + 0.1f * morph;
-    }
-
-    // Add intensity "Bloom"
-    params.roomSize = juce::jlimit(0.0f, 1.0f, params.roomSize + bloom * 0.5f);
-    params.width = 1.0f;
-
     // Auto-ducking: High intensity pushes reverb down initially to keep transients,
     // then it swells as intensity drops (modeled by smoothing)
-    float ducking = 1.0f - (intensity * 0.5f);
+    // Attacks duck a little harder so consonants stay dry and upfront.
+    float ducking = juce::jmax(0.0f, 1.0f - (intensity * 0.5f) - (detector.getTransientStrength() * 0.3f));
     float targetWet = mixAmount * ducking * (1.0f + bloom);
 
     smoothedWet.setTargetValue(juce::jlimit(0.0f, 1.0f, targetWet));
-    params.wetLevel = smoothedWet.getNextValue();
-    params.dryLevel = 1.0f;
+    return smoothedWet.getNextValue();
+}
+
+void SpaceModule::process(juce::AudioBuffer<float>& buffer, const PressureDetector& detector)
+{
+    float intensity = detector.getIntensity();
+    float bloom = characterAmount * intensity;
+    float wet = advanceWet(detector);
 
-    reverb.setParameters(params);
+    if (reverbState.needsUpdate({ characterAmount, intensity, wet }))
+    {
+        // Reverb parameters morphing: Room -> Plate -> Bloom
+        juce::Reverb::Parameters params;
+
+        if (characterAmount < 0.5f) // Room towards Plate
+        {
+            float morph = characterAmount * 2.0f;
+            params.roomSize = 0.1f * (1.0f - morph) + 0.6f * morph;
+            params.damping = 0.8f * (1.0f - morph) + 0.3f * morph;
+        }
+        else // Plate towards Bloom
+        {
+            float morph = (characterAmount - 0.5f) * 2.0f;
+            params.roomSize = 0.6f * (1.0f - morph) + 1.0f * morph;
+            params.damping = 0.3f * (1.0f - morph) + 0.1f * morph;
+        }
+
+        // Add intensity "Bloom"
+        params.roomSize = juce::jlimit(0.0f, 1.0f, params.roomSize + bloom * 0.5f);
+        params.width = 1.0f;
+        params.wetLevel = wet;
+        params.dryLevel = 1.0f;
+
+        reverb.setParameters(params);
+    }
 
     if (buffer.getNumChannels() == 1)
     {
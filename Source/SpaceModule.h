@@ -12,6 +12,7 @@
 
 #include <JuceHeader.h>
 #include "PressureDetector.h"
+#include "DerivedState.h"
 
 class SpaceModule
 {
@@ -22,6 +23,25 @@ public:
     void prepare(const juce::dsp::ProcessSpec& spec);
     void process(juce::AudioBuffer<float>& buffer, const PressureDetector& detector);
 
+    // Worst-case -60 dB decay for the current character, with full intensity bloom
+    float getTailSeconds() const;
+
+    // Ramp length of the wet level. It advances one step per block, so a ramp takes
+    // seconds * sampleRate blocks.
+    static constexpr double wetSmoothingSeconds = 0.05;
+
+    // Steps the wet level as process() does, without running the reverb, for a render
+    // that tracks it ahead of the audio. Returns the new level.
+    float advanceWet(const PressureDetector& detector);
+
+    // The wet level's smoothing, to carry it from one instance into another prepared
+    // at the same rate
+    const juce::LinearSmoothedValue<float>& getWetSmoothing() const { return smoothedWet; }
+    void setWetSmoothing(const juce::LinearSmoothedValue<float>& state) { smoothedWet = state; }
+
+    // Reverb parameter updates since construction, for the telemetry
+    juce::uint32 getRecomputeCount() const { return reverbState.getRecomputeCount(); }
+
     float mixAmount = 0.5f;
     float characterAmount = 0.5f; // 0: Room, 0.5: Plate, 1.0: Bloom
 
@@ -30,4 +50,7 @@ private:
     juce::Reverb reverb;
 
     juce::LinearSmoothedValue<float> smoothedWet { 0.0f };
+
+    // Reverb settings follow character, intensity (bloom) and the smoothed wet level
+    DerivedState<3> reverbState { { 0.002f, 0.005f, 0.002f } };
 };
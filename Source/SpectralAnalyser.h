@@ -0,0 +1,230 @@
+/*
+  ==============================================================================
+
+    SpectralAnalyser.h
+    Windowed STFT analysis shared by every spectral consumer in the rack.
+    Frames are written in place and read through a const reference, never copied.
+    A hop shorter than the block gives several frames per block; each keeps
+    its own slot in a small ring until the next block, so none is lost.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "BandSplitter.h"
+#include "DspTableCache.h"
+
+//==============================================================================
+struct SpectralFrame
+{
+    const float* magnitude = nullptr; // numBins linear magnitudes
+    const float* phase = nullptr;     // numBins phases in radians
+    int numBins = 0;
+    float binWidthHz = 0.0f;
+
+    float centroidHz = 0.0f;
+    float flatness = 0.0f;            // 0 = tonal / peaky, 1 = noise-like
+    float rolloffHz = 0.0f;           // 85% of the frame's energy lies below this
+
+    // Share of the frame's energy in each BandSplitter band (sums to ~1)
+    std::array<float, BandSplitter::numBands> bandEnergy {};
+
+    juce::uint64 frameIndex = 0;      // 0 until the first frame has been analysed
+};
+
+//==============================================================================
+class SpectralAnalyser
+{
+public:
+    static constexpr int defaultOrder = 11; // 2048 points
+    static constexpr int defaultHop   = 512;
+
+    SpectralAnalyser() {}
+    ~SpectralAnalyser() {}
+
+    // Takes effect on the next prepare(). The hop is clamped to the FFT size.
+    void setHopSize(int newHop)   { requestedHop = juce::jmax(1, newHop); }
+    void setFFTOrder(int newOrder) { requestedOrder = juce::jlimit(8, 14, newOrder); }
+
+    void prepare(double newSampleRate, int maximumBlockSize)
+    {
+        sampleRate = newSampleRate;
+        fftSize = 1 << requestedOrder;
+        hopSize = juce::jmin(requestedHop, fftSize);
+        numBins = fftSize / 2 + 1;
+
+        // Enough slots for every frame one block can produce
+        numSlots = maximumBlockSize / hopSize + 1;
+
+        if (fft == nullptr || fft->getSize() != fftSize)
+            fft = std::make_unique<juce::dsp::FFT>(requestedOrder);
+        window = tables->getWindow(DspTableCache::Window::hann, fftSize);
+
+        inputRing.assign((size_t) fftSize, 0.0f);
+        fftData.assign((size_t) fftSize * 2, 0.0f);
+        magnitude.assign((size_t) (numSlots * numBins), 0.0f);
+        phase.assign((size_t) (numSlots * numBins), 0.0f);
+        power.assign((size_t) numBins, 0.0f);
+
+        // Bin ranges matching the crossover bank, so both views agree on band edges
+        binWidth = (float) (sampleRate / fftSize);
+        const float edges[] = { BandSplitter::lowCrossover, BandSplitter::midCrossover, BandSplitter::highCrossover };
+        bandEdges[0] = 1;
+        for (int i = 0; i < 3; ++i)
+            bandEdges[(size_t) i + 1] = juce::jlimit(1, numBins, juce::roundToInt(edges[i] / binWidth));
+        bandEdges[BandSplitter::numBands] = numBins;
+
+        frames.assign((size_t) numSlots, SpectralFrame());
+        for (int slot = 0; slot < numSlots; ++slot)
+        {
+            auto& f = frames[(size_t) slot];
+            f.magnitude = magnitude.data() + slot * numBins;
+            f.phase = phase.data() + slot * numBins;
+            f.numBins = numBins;
+            f.binWidthHz = binWidth;
+        }
+
+        frameCount = 0;
+        reset();
+    }
+
+    void reset()
+    {
+        std::fill(inputRing.begin(), inputRing.end(), 0.0f);
+        writePos = 0;
+        samplesUntilFrame = hopSize;
+        framesThisBlock = 0;
+        firstSlotThisBlock = 0;
+    }
+
+    // Feeds a block of mono analysis samples and analyses a frame every hop.
+    void process(const float* samples, int numSamples)
+    {
+        framesThisBlock = 0;
+        firstSlotThisBlock = frameCount % (juce::uint64) numSlots;
+
+        while (numSamples > 0)
+        {
+            int toCopy = juce::jmin(numSamples, samplesUntilFrame, fftSize - writePos);
+            std::copy(samples, samples + toCopy, inputRing.begin() + writePos);
+
+            writePos = (writePos + toCopy) % fftSize;
+            samplesUntilFrame -= toCopy;
+            samples += toCopy;
+            numSamples -= toCopy;
+
+            if (samplesUntilFrame == 0)
+            {
+                analyseFrame();
+                samplesUntilFrame = hopSize;
+                ++framesThisBlock;
+            }
+        }
+    }
+
+    // The most recent frame, which may be from an earlier block
+    const SpectralFrame& getFrame() const { return frames[(size_t) ((frameCount + (juce::uint64) numSlots - 1) % (juce::uint64) numSlots)]; }
+
+    // The frames analysed during the last process() call, oldest first
+    const SpectralFrame& getFrame(int indexThisBlock) const
+    {
+        jassert (indexThisBlock >= 0 && indexThisBlock < framesThisBlock);
+        return frames[(size_t) ((firstSlotThisBlock + (juce::uint64) indexThisBlock) % (juce::uint64) numSlots)];
+    }
+
+    int getNumFramesThisBlock() const { return framesThisBlock; }
+    bool hasFrame() const             { return frameCount > 0; }
+
+    int getFFTSize() const { return fftSize; }
+    int getHopSize() const { return hopSize; }
+
+private:
+    void analyseFrame()
+    {
+        // Unwrap the ring, oldest sample first, and window it
+        int tail = fftSize - writePos;
+        std::copy(inputRing.begin() + writePos, inputRing.end(), fftData.begin());
+        std::copy(inputRing.begin(), inputRing.begin() + writePos, fftData.begin() + tail);
+        juce::FloatVectorOperations::multiply(fftData.data(), window->data(), fftSize);
+
+        fft->performRealOnlyForwardTransform(fftData.data(), true);
+
+        const int slot = (int) (frameCount % (juce::uint64) numSlots);
+        auto& frame = frames[(size_t) slot];
+        auto* frameMagnitude = magnitude.data() + slot * numBins;
+        auto* framePhase = phase.data() + slot * numBins;
+
+        const float norm = 2.0f / (float) fftSize;
+        float totalPower = 0.0f, weightedFreq = 0.0f, logSum = 0.0f;
+
+        for (int bin = 0; bin < numBins; ++bin)
+        {
+            float re = fftData[(size_t) bin * 2];
+            float im = fftData[(size_t) bin * 2 + 1];
+
+            float mag = std::sqrt(re * re + im * im) * norm;
+            frameMagnitude[bin] = mag;
+            framePhase[bin] = std::atan2(im, re);
+
+            float p = mag * mag + 1.0e-12f;
+            power[(size_t) bin] = p;
+            totalPower += p;
+            weightedFreq += p * (float) bin;
+            logSum += std::log(p);
+        }
+
+        frame.centroidHz = weightedFreq / totalPower * binWidth;
+        frame.flatness = juce::jlimit(0.0f, 1.0f, std::exp(logSum / (float) numBins) / (totalPower / (float) numBins));
+
+        float cumulative = 0.0f;
+        int rolloffBin = numBins - 1;
+        for (int bin = 0; bin < numBins; ++bin)
+        {
+            cumulative += power[(size_t) bin];
+            if (cumulative >= 0.85f * totalPower)
+            {
+                rolloffBin = bin;
+                break;
+            }
+        }
+        frame.rolloffHz = (float) rolloffBin * binWidth;
+
+        for (int b = 0; b < BandSplitter::numBands; ++b)
+        {
+            float bandPower = 0.0f;
+            for (int bin = bandEdges[(size_t) b]; bin < bandEdges[(size_t) b + 1]; ++bin)
+                bandPower += power[(size_t) bin];
+
+            frame.bandEnergy[(size_t) b] = bandPower / totalPower;
+        }
+
+        frame.frameIndex = ++frameCount;
+    }
+
+    double sampleRate = 44100.0;
+    int requestedOrder = defaultOrder;
+    int requestedHop = defaultHop;
+
+    int fftSize = 0;
+    int hopSize = defaultHop;
+    int numBins = 0;
+    int numSlots = 1;
+    float binWidth = 0.0f;
+
+    juce::SharedResourcePointer<DspTableCache> tables;
+    std::unique_ptr<juce::dsp::FFT> fft;
+    std::shared_ptr<const std::vector<float>> window;
+    std::vector<float> inputRing, fftData, magnitude, phase, power;
+    std::array<int, BandSplitter::numBands + 1> bandEdges {};
+
+    int writePos = 0;
+    int samplesUntilFrame = 0;
+    int framesThisBlock = 0;
+
+    std::vector<SpectralFrame> frames; // numSlots frames over numSlots * numBins bins
+    juce::uint64 frameCount = 0, firstSlotThisBlock = 0;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (SpectralAnalyser)
+};
@@ -0,0 +1,217 @@
+/*
+  ==============================================================================
+
+    SpectralDeReverb.h
+    Late-reverb suppressor for the Dynamics "de-reverb" range. Each band's
+    decay time is estimated blind from how its energy falls away, the late
+    tail is predicted per bin from the power seen 50 ms earlier, and that
+    share is subtracted from the spectrum.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "BandSplitter.h"
+#include "SpectralProcessor.h"
+
+class SpectralDeReverb : private SpectralProcessor
+{
+public:
+    SpectralDeReverb() {}
+    ~SpectralDeReverb() override {}
+
+    void prepare(const juce::dsp::ProcessSpec& spec)
+    {
+        // Same ~11 ms frames as the resonance suppressor
+        prepareSpectral(spec.sampleRate, (int) spec.numChannels, spec.sampleRate > 50000.0 ? 10 : 9);
+
+        const int bins = getNumBins();
+        const int numChannels = (int) spec.numChannels;
+        frameSeconds = (float) getHopSize() / (float) spec.sampleRate;
+
+        // Frames between the direct sound and the start of the late tail
+        historyLength = juce::jmax(1, juce::roundToInt(lateReverbDelay / frameSeconds));
+
+        power.assign((size_t) bins * numChannels, 0.0f);
+        history.assign((size_t) bins * numChannels * historyLength, 0.0f);
+        gains.assign((size_t) bins * numChannels, 1.0f);
+        lateReverb.assign((size_t) bins, 0.0f);
+
+        // Bin ranges matching the crossover bank, as in SpectralAnalyser
+        const float binWidth = (float) (spec.sampleRate / getFFTSize());
+        const float edges[] = { BandSplitter::lowCrossover, BandSplitter::midCrossover, BandSplitter::highCrossover };
+        bandEdges[0] = 0;
+        for (int i = 0; i < 3; ++i)
+            bandEdges[(size_t) i + 1] = juce::jlimit(1, bins, juce::roundToInt(edges[i] / binWidth));
+        bandEdges[BandSplitter::numBands] = bins;
+
+        bandState.assign((size_t) numChannels, {});
+
+        gainAttack  = 1.0f - std::exp(-frameSeconds / 0.004f);
+        gainRelease = 1.0f - std::exp(-frameSeconds / 0.040f);
+        decayLearn  = 1.0f - std::exp(-frameSeconds / 0.5f);
+
+        reset();
+    }
+
+    void reset()
+    {
+        resetSpectral();
+        std::fill(power.begin(), power.end(), 0.0f);
+        std::fill(history.begin(), history.end(), 0.0f);
+        std::fill(gains.begin(), gains.end(), 1.0f);
+
+        for (auto& state : bandState)
+        {
+            state.previousDb.fill(-200.0f);
+            state.rt60.fill(defaultRT60);
+        }
+
+        historyPos = 0;
+        reductionDb = 0.0f;
+    }
+
+    // Call every block while the owner reports this stage's latency, even at zero depth.
+    void process(juce::AudioBuffer<float>& buffer, float newDepth)
+    {
+        depth = juce::jlimit(0.0f, 1.0f, newDepth);
+
+        bool active = depth > 0.0f;
+        if (! active && wasActive)
+        {
+            std::fill(gains.begin(), gains.end(), 1.0f);
+            reductionDb = 0.0f;
+        }
+        wasActive = active;
+
+        processSpectral(buffer, active);
+    }
+
+    using SpectralProcessor::getLatencySamples;
+
+    // Average suppression over the last frame, in dB (positive = cut)
+    float getGainReductionDb() const { return reductionDb; }
+
+    // Current decay-time estimate for a band, averaged over channels
+    float getRT60(BandSplitter::Band band) const
+    {
+        float sum = 0.0f;
+        for (auto& state : bandState)
+            sum += state.rt60[(size_t) band];
+        return bandState.empty() ? defaultRT60 : sum / (float) bandState.size();
+    }
+
+private:
+    static constexpr float lateReverbDelay = 0.05f; // Late tail starts ~50 ms after the direct sound
+    static constexpr float defaultRT60     = 0.6f;
+    static constexpr float minRT60         = 0.15f;
+    static constexpr float maxRT60         = 2.5f;
+
+    struct BandState
+    {
+        std::array<float, BandSplitter::numBands> previousDb {};
+        std::array<float, BandSplitter::numBands> rt60 {};
+    };
+
+    void processSpectrum(int channel, float* bins) override
+    {
+        const int numBins = getNumBins();
+        const size_t offset = (size_t) channel * (size_t) numBins;
+        auto* smoothedPower = power.data() + offset;
+        auto* binGains = gains.data() + offset;
+        auto* delayedPower = history.data() + ((size_t) channel * (size_t) historyLength + (size_t) historyPos) * (size_t) numBins;
+
+        // Recursively smoothed power, which keeps the estimate from chasing single frames
+        for (int bin = 0; bin < numBins; ++bin)
+        {
+            float re = bins[bin * 2], im = bins[bin * 2 + 1];
+            smoothedPower[bin] = 0.5f * smoothedPower[bin] + 0.5f * (re * re + im * im);
+        }
+
+        // Predicted late reverb: the power one late-delay ago, decayed at each band's RT60
+        auto& state = bandState[(size_t) channel];
+        for (int b = 0; b < BandSplitter::numBands; ++b)
+        {
+            const int first = bandEdges[(size_t) b], last = bandEdges[(size_t) b + 1];
+
+            float bandPower = 1.0e-12f;
+            for (int bin = first; bin < last; ++bin)
+                bandPower += smoothedPower[bin];
+
+            updateDecayEstimate(state, b, 10.0f * std::log10(bandPower));
+
+            float decay = std::pow(10.0f, -6.0f * lateReverbDelay / state.rt60[(size_t) b]);
+            for (int bin = first; bin < last; ++bin)
+                lateReverb[(size_t) bin] = decay * delayedPower[bin];
+        }
+
+        // Spectral subtraction with a depth-dependent floor, smoothed against musical noise
+        const float floorGain = std::pow(10.0f, -18.0f * depth / 20.0f);
+        float sum = 0.0f;
+        for (int bin = 0; bin < numBins; ++bin)
+        {
+            float ratio = lateReverb[(size_t) bin] / (smoothedPower[bin] + 1.0e-12f);
+            float target = std::sqrt(juce::jmax(floorGain * floorGain, 1.0f - depth * ratio));
+            float delta = target - binGains[bin];
+            binGains[bin] += juce::jmin(delta, 0.0f) * gainAttack + juce::jmax(delta, 0.0f) * gainRelease;
+            sum += binGains[bin];
+        }
+
+        for (int bin = 0; bin < numBins; ++bin)
+        {
+            bins[bin * 2]     *= binGains[bin];
+            bins[bin * 2 + 1] *= binGains[bin];
+        }
+
+        std::copy(smoothedPower, smoothedPower + numBins, delayedPower);
+
+        frameReduction = juce::jmax(frameReduction, -20.0f * std::log10(juce::jmax(1.0e-6f, sum / (float) numBins)));
+    }
+
+    // Blind decay estimate: free decays (steady, moderate drops) are taken as the room's
+    // tail; abrupt drops are note endings and rises are new energy, so both are ignored.
+    void updateDecayEstimate(BandState& state, int band, float levelDb)
+    {
+        float dropDb = state.previousDb[(size_t) band] - levelDb;
+        state.previousDb[(size_t) band] = levelDb;
+
+        if (levelDb < -90.0f || dropDb <= 0.01f)
+            return;
+
+        float observed = 60.0f * frameSeconds / dropDb;
+        if (observed < minRT60)
+            return;
+
+        auto& rt60 = state.rt60[(size_t) band];
+        rt60 += (juce::jmin(observed, maxRT60) - rt60) * decayLearn;
+    }
+
+    void frameProcessed(bool active) override
+    {
+        if (active)
+        {
+            historyPos = (historyPos + 1) % historyLength;
+            reductionDb = frameReduction;
+        }
+        frameReduction = 0.0f;
+    }
+
+    float frameSeconds = 0.0f;
+    int historyLength = 1;
+    int historyPos = 0;
+
+    std::vector<float> power, history, gains, lateReverb;
+    std::array<int, BandSplitter::numBands + 1> bandEdges {};
+    std::vector<BandState> bandState;
+
+    float gainAttack = 0.5f, gainRelease = 0.1f, decayLearn = 0.01f;
+    float depth = 0.0f;
+    bool wasActive = false;
+
+    float frameReduction = 0.0f;
+    float reductionDb = 0.0f;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (SpectralDeReverb)
+};
@@ -0,0 +1,153 @@
+/*
+  ==============================================================================
+
+    SpectralProcessor.h
+    Streaming STFT engine with a preallocated overlap-add path. Subclasses
+    modify each frame's spectrum in place; everything else (windowing,
+    framing, latency) lives here. Latency is one FFT frame.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "DspTableCache.h"
+
+class SpectralProcessor
+{
+public:
+    SpectralProcessor() {}
+    virtual ~SpectralProcessor() {}
+
+    // 75% overlap, sqrt-Hann analysis and synthesis windows
+    void prepareSpectral(double newSampleRate, int numChannels, int newFFTOrder)
+    {
+        sampleRate = newSampleRate;
+        fftOrder = newFFTOrder;
+        fftSize = 1 << fftOrder;
+        hopSize = fftSize / 4;
+        numBins = fftSize / 2 + 1;
+
+        if (fft == nullptr || fft->getSize() != fftSize)
+            fft = std::make_unique<juce::dsp::FFT>(fftOrder);
+        window = tables->getWindow(DspTableCache::Window::sqrtHann, fftSize);
+
+        // Periodic Hann at a quarter-frame hop overlaps to a constant 2
+        olaScale = 0.5f;
+
+        channels.resize((size_t) numChannels);
+        for (auto& c : channels)
+        {
+            c.input.assign((size_t) fftSize, 0.0f);
+            c.output.assign((size_t) fftSize, 0.0f);
+        }
+        frame.assign((size_t) fftSize * 2, 0.0f);
+
+        resetSpectral();
+    }
+
+    void resetSpectral()
+    {
+        for (auto& c : channels)
+        {
+            std::fill(c.input.begin(), c.input.end(), 0.0f);
+            std::fill(c.output.begin(), c.output.end(), 0.0f);
+        }
+        ringPos = 0;
+        hopCounter = 0;
+    }
+
+    // When inactive the frames are overlap-added straight back in the time domain:
+    // same latency and no discontinuity when switching, but no FFTs are run.
+    void processSpectral(juce::AudioBuffer<float>& buffer, bool active)
+    {
+        const int numChannels = juce::jmin(buffer.getNumChannels(), (int) channels.size());
+        const int numSamples = buffer.getNumSamples();
+
+        int start = 0;
+        while (start < numSamples)
+        {
+            int chunk = juce::jmin(numSamples - start, hopSize - hopCounter, fftSize - ringPos);
+
+            for (int ch = 0; ch < numChannels; ++ch)
+            {
+                auto* data = buffer.getWritePointer(ch, start);
+                auto& c = channels[(size_t) ch];
+
+                std::copy(data, data + chunk, c.input.begin() + ringPos);
+                std::copy(c.output.begin() + ringPos, c.output.begin() + ringPos + chunk, data);
+                std::fill(c.output.begin() + ringPos, c.output.begin() + ringPos + chunk, 0.0f);
+            }
+
+            ringPos = (ringPos + chunk) % fftSize;
+            hopCounter += chunk;
+            start += chunk;
+
+            if (hopCounter == hopSize)
+            {
+                hopCounter = 0;
+                for (int ch = 0; ch < numChannels; ++ch)
+                    processFrame(ch, active);
+                frameProcessed(active);
+            }
+        }
+    }
+
+    int getLatencySamples() const { return fftSize; }
+    int getFFTSize() const        { return fftSize; }
+    int getNumBins() const        { return numBins; }
+    int getHopSize() const        { return hopSize; }
+
+protected:
+    // Called once per channel per frame with numBins interleaved (re, im) pairs.
+    virtual void processSpectrum(int channel, float* bins) = 0;
+
+    // Called after all channels of a frame have been processed.
+    virtual void frameProcessed(bool active) { juce::ignoreUnused(active); }
+
+    double sampleRate = 44100.0;
+
+private:
+    void processFrame(int ch, bool active)
+    {
+        auto& c = channels[(size_t) ch];
+        const auto& w = *window;
+
+        // Oldest sample first
+        for (int i = 0; i < fftSize; ++i)
+            frame[(size_t) i] = c.input[(size_t) ((ringPos + i) % fftSize)] * w[(size_t) i];
+
+        if (active)
+        {
+            fft->performRealOnlyForwardTransform(frame.data(), true);
+            processSpectrum(ch, frame.data());
+            fft->performRealOnlyInverseTransform(frame.data());
+        }
+
+        for (int i = 0; i < fftSize; ++i)
+            c.output[(size_t) ((ringPos + i) % fftSize)] += frame[(size_t) i] * w[(size_t) i] * olaScale;
+    }
+
+    struct ChannelState
+    {
+        std::vector<float> input, output;
+    };
+
+    int fftOrder = 9;
+    int fftSize = 512;
+    int hopSize = 128;
+    int numBins = 257;
+    float olaScale = 0.5f;
+
+    juce::SharedResourcePointer<DspTableCache> tables;
+    std::unique_ptr<juce::dsp::FFT> fft;
+    std::shared_ptr<const std::vector<float>> window;
+    std::vector<float> frame;
+    std::vector<ChannelState> channels;
+
+    int ringPos = 0;
+    int hopCounter = 0;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (SpectralProcessor)
+};
@@ -0,0 +1,175 @@
+/*
+  ==============================================================================
+
+    Telemetry.h
+    Per-block measurements handed from the audio thread to the editor through
+    a wait-free single-producer / single-consumer ring. The audio thread never
+    blocks or allocates; if the editor falls behind, new frames are dropped.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+//==============================================================================
+enum class TelemetryStage
+{
+    dynamics,
+    deReverb,
+    tame,
+    wall,
+    numStages
+};
+
+//==============================================================================
+// One audio block's worth of measurements. Cache-line aligned so neighbouring
+// slots never share a line with the one being written.
+struct alignas(64) TelemetryFrame
+{
+    static constexpr int maxChannels = 8;
+    static constexpr int numStages = (int) TelemetryStage::numStages;
+
+    juce::uint64 blockIndex = 0;
+    int numSamples = 0;
+    int numChannels = 0;
+
+    // Pressure Detector
+    float intensity = 0.0f;
+    float density = 0.0f;
+    float timbre = 0.0f;
+    float pitchHz = 0.0f;
+    float pitchConfidence = 0.0f;
+    float transient = 0.0f;
+
+    // Spectral shape of the analysis signal, averaged over the block's STFT frames
+    float spectralCentroidHz = 0.0f;
+    float spectralFlatness = 0.0f;
+
+    // Output level from the MeteringEngine, linear
+    std::array<float, maxChannels> peak {};
+    std::array<float, maxChannels> truePeak {};
+    std::array<float, maxChannels> rms {};     // 300 ms window
+
+    // Loudness ahead of the makeup gain, and the makeup applied
+    float momentaryLUFS = -70.0f;
+    float shortTermLUFS = -70.0f;
+    float integratedLUFS = -70.0f;
+    float makeupGainDb = 0.0f;
+
+    // Positive dB of gain taken off by each stage during the block
+    std::array<float, numStages> gainReductionDb {};
+
+    // Derived-state rebuilds since the instance was created; diff two frames for a rate
+    juce::uint32 eqRecomputes = 0;    // Scoop and Bite coefficients
+    juce::uint32 spaceRecomputes = 0; // Reverb parameters
+    juce::uint32 shiftRecomputes = 0; // Shift ratio
+
+    float getGainReductionDb(TelemetryStage stage) const { return gainReductionDb[(size_t) stage]; }
+    void setGainReductionDb(TelemetryStage stage, float db) { gainReductionDb[(size_t) stage] = db; }
+
+    float getMaxPeak() const     { return getMax(peak); }
+    float getMaxTruePeak() const { return getMax(truePeak); }
+
+private:
+    float getMax(const std::array<float, maxChannels>& levels) const
+    {
+        float level = 0.0f;
+        for (int ch = 0; ch < numChannels; ++ch)
+            level = juce::jmax(level, levels[(size_t) ch]);
+        return level;
+    }
+};
+
+//==============================================================================
+template <int Capacity>
+class TelemetryFifo
+{
+public:
+    static_assert((Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+
+    TelemetryFifo() {}
+    ~TelemetryFifo() {}
+
+    // Audio thread only. Returns false (and drops the frame) when the ring is full.
+    bool push(const TelemetryFrame& frame) noexcept
+    {
+        const auto head = writeIndex.load(std::memory_order_relaxed);
+        if (head - cachedReadIndex == (juce::uint32) Capacity)
+        {
+            cachedReadIndex = readIndex.load(std::memory_order_acquire);
+            if (head - cachedReadIndex == (juce::uint32) Capacity)
+            {
+                droppedFrames.store(droppedFrames.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+                return false;
+            }
+        }
+
+        slots[head & mask] = frame;
+        writeIndex.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Message thread only. Returns false when there is nothing to read.
+    bool pop(TelemetryFrame& frame) noexcept
+    {
+        const auto tail = readIndex.load(std::memory_order_relaxed);
+        if (tail == cachedWriteIndex)
+        {
+            cachedWriteIndex = writeIndex.load(std::memory_order_acquire);
+            if (tail == cachedWriteIndex)
+                return false;
+        }
+
+        frame = slots[tail & mask];
+        readIndex.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    juce::uint32 getNumDroppedFrames() const noexcept { return droppedFrames.load(std::memory_order_relaxed); }
+
+private:
+    static constexpr juce::uint32 mask = (juce::uint32) Capacity - 1;
+
+    std::array<TelemetryFrame, (size_t) Capacity> slots;
+
+    // Producer and consumer state each live on their own cache line
+    alignas(64) std::atomic<juce::uint32> writeIndex { 0 };
+    juce::uint32 cachedReadIndex = 0;
+    std::atomic<juce::uint32> droppedFrames { 0 };
+
+    alignas(64) std::atomic<juce::uint32> readIndex { 0 };
+    juce::uint32 cachedWriteIndex = 0;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (TelemetryFifo)
+};
+
+//==============================================================================
+// Editor-side history of the most recent frames, oldest first.
+template <int Length>
+class TelemetryHistory
+{
+public:
+    void add(const TelemetryFrame& frame)
+    {
+        frames[(size_t) writePos] = frame;
+        writePos = (writePos + 1) % Length;
+        numFrames = juce::jmin(numFrames + 1, Length);
+    }
+
+    int size() const { return numFrames; }
+
+    // 0 = oldest held frame, size() - 1 = newest
+    const TelemetryFrame& operator[](int index) const
+    {
+        return frames[(size_t) ((writePos - numFrames + index + Length) % Length)];
+    }
+
+    const TelemetryFrame& getLatest() const { return (*this)[numFrames - 1]; }
+
+private:
+    std::array<TelemetryFrame, (size_t) Length> frames;
+    int writePos = 0;
+    int numFrames = 0;
+};
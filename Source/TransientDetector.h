@@ -0,0 +1,114 @@
+/*
+  ==============================================================================
+
+    TransientDetector.h
+    Dual-envelope onset detector. Emits a per-sample transient strength lane
+    and the sample positions of onsets, at a small fixed cost per sample.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+class TransientDetector
+{
+public:
+    static constexpr int maxOnsetsPerBlock = 16;
+
+    // The slowest envelope's time constant, which bounds how long the detector remembers
+    static constexpr double slowReleaseMs = 200.0;
+
+    TransientDetector() {}
+    ~TransientDetector() {}
+
+    void prepare(double sampleRate, int maximumBlockSize)
+    {
+        auto coeff = [sampleRate](double ms) { return (float) std::exp(-1.0 / (sampleRate * ms * 0.001)); };
+
+        // The fast envelope follows consonant attacks, the slow one the sustained body
+        fastAttack  = coeff(0.5);
+        fastRelease = coeff(15.0);
+        slowAttack  = coeff(30.0);
+        slowRelease = coeff(slowReleaseMs);
+
+        holdOffSamples = (int) (sampleRate * 0.05); // At most one onset per 50 ms
+
+        lane.assign((size_t) juce::jmax(1, maximumBlockSize), 0.0f);
+        reset();
+    }
+
+    void reset()
+    {
+        fastEnv = slowEnv = 0.0f;
+        samplesSinceOnset = holdOffSamples;
+        armed = true;
+        blockPeak = 0.0f;
+        numOnsets = 0;
+    }
+
+    void process(const float* samples, int numSamples)
+    {
+        numSamples = juce::jmin(numSamples, (int) lane.size());
+        numOnsets = 0;
+        blockPeak = 0.0f;
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            float rectified = std::abs(samples[i]);
+
+            fastEnv = rectified + (fastEnv - rectified) * (rectified > fastEnv ? fastAttack : fastRelease);
+            slowEnv = rectified + (slowEnv - rectified) * (rectified > slowEnv ? slowAttack : slowRelease);
+
+            // How far the attack envelope has jumped ahead of the body, ignoring the noise floor
+            float strength = 0.0f;
+            if (fastEnv > levelFloor)
+                strength = juce::jlimit(0.0f, 1.0f, (fastEnv / (slowEnv + levelFloor) - 1.0f) * 0.5f);
+
+            lane[(size_t) i] = strength;
+            blockPeak = juce::jmax(blockPeak, strength);
+
+            // Saturates, since only reaching the hold-off matters
+            samplesSinceOnset = juce::jmin(samplesSinceOnset + 1, holdOffSamples);
+            if (armed && strength > onsetThreshold && samplesSinceOnset >= holdOffSamples)
+            {
+                if (numOnsets < maxOnsetsPerBlock)
+                    onsets[(size_t) numOnsets++] = i;
+
+                samplesSinceOnset = 0;
+                armed = false;
+            }
+            else if (strength < rearmThreshold)
+            {
+                armed = true;
+            }
+        }
+    }
+
+    const float* getLane() const       { return lane.data(); } // Valid for the last processed block
+    float getBlockPeak() const         { return blockPeak; }
+    int getNumOnsets() const           { return numOnsets; }
+    int getOnsetPosition(int i) const  { return onsets[(size_t) i]; }
+
+private:
+    static constexpr float levelFloor     = 0.003f; // ~ -50 dBFS
+    static constexpr float onsetThreshold = 0.3f;
+    static constexpr float rearmThreshold = 0.1f;
+
+    float fastAttack = 0.0f, fastRelease = 0.0f;
+    float slowAttack = 0.0f, slowRelease = 0.0f;
+    float fastEnv = 0.0f, slowEnv = 0.0f;
+
+    int holdOffSamples = 0;
+    int samplesSinceOnset = 0;
+    bool armed = true;
+
+    std::vector<float> lane;
+    float blockPeak = 0.0f;
+
+    std::array<int, maxOnsetsPerBlock> onsets {};
+    int numOnsets = 0;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (TransientDetector)
+};
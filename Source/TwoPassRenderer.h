@@ -0,0 +1,119 @@
+/*
+  ==============================================================================
+
+    TwoPassRenderer.h
+    Offline render in two passes. Pass one runs the PressureDetector over the
+    whole take into a PressureTrajectory, cached on disk by the audio's key.
+    Pass two renders the chain with pressure and pitch read from the
+    trajectory, so the heavy analysis (band split, STFT, pitch) never runs
+    live and re-rendering with new module settings reuses the cached pass.
+
+    The chain's own latency is trimmed from the output, so pass two's output
+    lines up with the input sample for sample. The trajectory is centred on
+    the audio rather than trailing it, but it is block-rate: each block's
+    point describes that input block. Stages after de-reverb and Tame hear
+    the audio late by those stages' latency; the chain hands them the point
+    of the block that held their audio, so the pressure they follow is
+    aligned to within a block, not to the sample.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "RackEngine.h"
+#include "PressureTrajectory.h"
+
+class TwoPassRenderer
+{
+public:
+    struct Options
+    {
+        int blockSize = 512;
+        bool monoInput = false;      // Input channel 0 only, rendered as the plugin's mono-in/stereo-out
+        juce::File cacheDirectory;   // Where trajectories are kept; none if left empty
+    };
+
+    struct Report
+    {
+        bool trajectoryFromCache = false;
+        double analysisSeconds = 0.0; // Pass one, or loading it from the cache
+        double renderSeconds = 0.0;   // Pass two
+        size_t trajectoryBytes = 0;
+    };
+
+    explicit TwoPassRenderer(const Options& optionsToUse) : options(optionsToUse) {}
+    ~TwoPassRenderer() {}
+
+    // Renders input into a stereo output of the same length
+    Report render(const juce::AudioBuffer<float>& input, juce::AudioBuffer<float>& output, double sampleRate,
+                  const RackSettings& settings, const RackChain::Switches& switches = {})
+    {
+        Report report;
+        const int length = input.getNumSamples();
+        const int blockSize = options.blockSize;
+        output.setSize(2, length, false, false, true);
+
+        // Pass one, unless this take has been analysed with these settings before
+        auto startTime = juce::Time::getMillisecondCounterHiRes();
+        const auto key = PressureTrajectory::makeKey(input, sampleRate, blockSize, options.monoInput);
+
+        juce::File cacheFile;
+        if (options.cacheDirectory != juce::File())
+            cacheFile = options.cacheDirectory.getChildFile(juce::String::toHexString((juce::int64) key) + ".vapt");
+
+        PressureTrajectory trajectory;
+        report.trajectoryFromCache = cacheFile.existsAsFile() && trajectory.load(cacheFile, key, blockSize, options.monoInput);
+
+        if (! report.trajectoryFromCache)
+        {
+            trajectory.analyse(input, sampleRate, blockSize, options.monoInput, key);
+
+            if (cacheFile != juce::File() && options.cacheDirectory.createDirectory())
+                trajectory.save(cacheFile);
+        }
+
+        report.analysisSeconds = (juce::Time::getMillisecondCounterHiRes() - startTime) * 0.001;
+        report.trajectoryBytes = trajectory.getSizeBytes();
+
+        // Pass two, running on past the end by the latency so the trimmed output is complete
+        startTime = juce::Time::getMillisecondCounterHiRes();
+
+        RackEngine engine;
+        engine.prepare(sampleRate, blockSize, 1, options.monoInput);
+        engine.setStreamSettings(0, settings, switches);
+
+        const int latency = engine.getLatencySamples();
+        const int inputChannels = options.monoInput ? 1 : juce::jmin(2, input.getNumChannels());
+        juce::AudioBuffer<float> work (2, blockSize);
+
+        for (int position = 0; position < length + latency; position += blockSize)
+        {
+            const int numSamples = juce::jmin(blockSize, length + latency - position);
+            juce::AudioBuffer<float> block (work.getArrayOfWritePointers(), 2, numSamples);
+            block.clear();
+
+            const int available = juce::jlimit(0, numSamples, length - position);
+            for (int channel = 0; channel < inputChannels; ++channel)
+                block.copyFrom(channel, 0, input, channel, position, available);
+
+            // The point for this input block; the chain delays it for the stages that hear it late
+            engine.process(0, block, trajectory.getPoint(position / blockSize));
+
+            // Output sample i belongs to input sample i - latency
+            const int first = juce::jmax(0, latency - position);
+            const int destination = position + first - latency;
+            const int count = juce::jmin(numSamples - first, length - destination);
+            for (int channel = 0; channel < 2 && count > 0; ++channel)
+                output.copyFrom(channel, destination, block, channel, first, count);
+        }
+
+        report.renderSeconds = (juce::Time::getMillisecondCounterHiRes() - startTime) * 0.001;
+        return report;
+    }
+
+private:
+    Options options;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (TwoPassRenderer)
+};
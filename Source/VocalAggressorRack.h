@@ -11,13 +11,14 @@
 #pragma once
 
 #include "PressureDetector.h"
-#include "DynamicsModule.h"
-#include "EQModule.h"
-#include "HarmonicsModule.h"
-#include "ShiftModule.h"
-#include "SpaceModule.h"
-#include "ClipperModule.h"
-#include "WidenerModule.h"
+#include "PressureLink.h"
+#include "RackChain.h"
+#include "MeteringEngine.h"
+#include "Telemetry.h"
+#include "ScratchArena.h"
+#include "SilenceGate.h"
+#include "BinaryStateCodec.h"
+#include "PresetSlots.h"
 
 class VocalAggressorRackEditor;
 
@@ -25,16 +26,31 @@ class VocalAggressorRackEditor;
 class VocalAggressorRack  : public juce::AudioProcessor
 {
 public:
+    // Optional stereo buses for doubles, processed alongside the lead on the main bus
+    static constexpr int maxDoubles = 6;
+
     //==============================================================================
     VocalAggressorRack()
-        : AudioProcessor (BusesProperties().withInput  ("Input",  juce::AudioChannelSet::stereo(), true)
-                                           .withOutput ("Output", juce::AudioChannelSet::stereo(), true)
-                                           .withInput  ("Sidechain", juce::AudioChannelSet::stereo(), false)),
-          apvts (*this, nullptr, "Parameters", createParameterLayout())
+        : AudioProcessor (createBusesProperties()),
+          apvts (*this, nullptr, "Parameters", createParameterLayout()),
+          stateCodec (*this)
     {
     }
 
     //==============================================================================
+    static BusesProperties createBusesProperties()
+    {
+        auto buses = BusesProperties().withInput  ("Input",  juce::AudioChannelSet::stereo(), true)
+                                      .withOutput ("Output", juce::AudioChannelSet::stereo(), true)
+                                      .withInput  ("Sidechain", juce::AudioChannelSet::stereo(), false);
+
+        for (int i = 1; i <= maxDoubles; ++i)
+            buses = buses.withInput  ("Double " + juce::String (i), juce::AudioChannelSet::stereo(), false)
+                         .withOutput ("Double " + juce::String (i), juce::AudioChannelSet::stereo(), false);
+
+        return buses;
+    }
+
     static juce::AudioProcessorValueTreeState::ParameterLayout createParameterLayout()
     {
         juce::AudioProcessorValueTreeState::ParameterLayout layout;
@@ -48,6 +64,7 @@ public:
 
         layout.add (std::make_unique<juce::AudioParameterFloat>  ("eq_scoop", "EQ Scoop", 0.0f, 1.0f, 0.5f));
         layout.add (std::make_unique<juce::AudioParameterFloat>  ("eq_bite", "EQ Bite", 0.0f, 1.0f, 0.5f));
+        layout.add (std::make_unique<juce::AudioParameterFloat>  ("eq_tame", "EQ Tame (Resonance)", 0.0f, 1.0f, 0.0f));
         layout.add (std::make_unique<juce::AudioParameterBool>   ("bypass_eq", "Bypass EQ", false));
 
         layout.add (std::make_unique<juce::AudioParameterFloat>  ("harm_grit", "Harmonics Grit", 0.0f, 1.0f, 0.5f));
@@ -56,6 +73,8 @@ public:
 
         layout.add (std::make_unique<juce::AudioParameterFloat>  ("shift_pitch", "Pitch Shift", 0.0f, 1.0f, 0.5f));
         layout.add (std::make_unique<juce::AudioParameterFloat>  ("shift_formant", "Formant Shift", 0.0f, 1.0f, 0.5f));
+        layout.add (std::make_unique<juce::AudioParameterInt>    ("shift_voices", "Doubler Voices", 0, ShiftModule::maxVoices, 0));
+        layout.add (std::make_unique<juce::AudioParameterFloat>  ("shift_spread", "Doubler Spread", 0.0f, 1.0f, 0.5f));
         layout.add (std::make_unique<juce::AudioParameterBool>   ("bypass_shift", "Bypass Shift", false));
 
         layout.add (std::make_unique<juce::AudioParameterFloat>  ("space_mix", "Space Mix", 0.0f, 1.0f, 0.5f));
@@ -66,6 +85,17 @@ public:
         layout.add (std::make_unique<juce::AudioParameterFloat>  ("wall_drive", "The Wall (Drive)", 0.0f, 12.0f, 0.0f));
         layout.add (std::make_unique<juce::AudioParameterFloat>  ("wall_ceil", "The Wall (Ceiling)", -12.0f, 0.0f, -0.1f));
 
+        layout.add (std::make_unique<juce::AudioParameterChoice> ("makeup_mode", "Makeup Gain", juce::StringArray { "Off", "Match Input", "Target" }, 0));
+        layout.add (std::make_unique<juce::AudioParameterFloat>  ("makeup_target", "Makeup Target (LUFS)", -30.0f, -6.0f, -14.0f));
+
+        layout.add (std::make_unique<juce::AudioParameterBool>   ("ab_enabled", "A/B Morph", false));
+        layout.add (std::make_unique<juce::AudioParameterFloat>  ("ab_morph", "A/B Morph Position", 0.0f, 1.0f, 0.0f));
+
+        layout.add (std::make_unique<juce::AudioParameterChoice> ("bus_key", "Double Bus Key", juce::StringArray { "Lead", "Sum" }, 0));
+
+        layout.add (std::make_unique<juce::AudioParameterChoice> ("link_mode", "Pressure Link", juce::StringArray { "Off", "Publish", "Subscribe" }, 0));
+        layout.add (std::make_unique<juce::AudioParameterInt>    ("link_id", "Pressure Link ID", 1, PressureLink::numLinks, 1));
+
         return layout;
     }
 
@@ -75,26 +105,73 @@ public:
         juce::dsp::ProcessSpec spec;
         spec.sampleRate = sampleRate;
         spec.maximumBlockSize = samplesPerBlock;
-        spec.numChannels = getTotalNumOutputChannels();
-
-        pressureDetector.prepare(spec);
-        dynamicsModule.prepare(spec);
-        eqModule.prepare(spec);
-        harmonicsModule.prepare(spec);
-        shiftModule.prepare(spec);
-        spaceModule.prepare(spec);
-        widenerModule.prepare(spec);
-        clipperModule.prepare(spec);
-
-        dryBuffer.setSize(getTotalNumOutputChannels(), samplesPerBlock);
+        spec.numChannels = getMainBusNumOutputChannels();
+
+        // Mono in, stereo out: the lead's stages ahead of Shift only ever see one channel,
+        // and so does the detector
+        const bool monoLead = getMainBusNumInputChannels() == 1 && getMainBusNumOutputChannels() == 2;
+        keyChannels = monoLead ? 1 : (int) spec.numChannels;
+
+        auto keySpec = spec;
+        keySpec.numChannels = (juce::uint32) keyChannels;
+        pressureDetector.prepare(keySpec);
+
+        // Joins the shared workers here, off the audio thread; processBlock() only switches
+        // between them and inline analysis
+        pressureDetector.setUseWorkerPool(true);
+
+        chains[0].prepare(spec, monoLead);
+
+        auto doubleSpec = spec;
+        doubleSpec.numChannels = 2;
+        numDoubles = 0;
+        for (int i = 0; i < maxDoubles; ++i)
+        {
+            doubleActive[(size_t) i] = getChannelCountOfBus (true, doubleInputBus + i) == 2
+                                    && getChannelCountOfBus (false, doubleOutputBus + i) == 2;
+            if (doubleActive[(size_t) i])
+            {
+                chains[(size_t) (1 + i)].prepare(doubleSpec, false);
+                ++numDoubles;
+            }
+        }
+
+        meteringEngine.prepare(sampleRate, getMainBusNumOutputChannels());
+
+        prepareScratch(keySpec);
+
+        // Every bus runs the same chain, so they share one latency. It counts both spectral
+        // stages whatever the settings, so it never moves during playback.
+        setLatencySamples(chains[0].getLatencySamples());
+        updateParameters();
+
+        silenceGate.prepare(chains[0].getRingSamples());
+        updateTailLength();
     }
 
     void releaseResources() override {}
 
     bool isBusesLayoutSupported (const BusesLayout& layouts) const override
     {
-        if (layouts.getMainOutputChannelSet() != layouts.getMainInputChannelSet())
+        auto in = layouts.getMainInputChannelSet();
+        auto out = layouts.getMainOutputChannelSet();
+
+        if (! (in == out || (in == juce::AudioChannelSet::mono() && out == juce::AudioChannelSet::stereo())))
             return false;
+
+        // Doubles are stereo in and out, or switched off on both sides
+        for (int i = 0; i < maxDoubles; ++i)
+        {
+            if (doubleInputBus + i >= layouts.inputBuses.size() || doubleOutputBus + i >= layouts.outputBuses.size())
+                break;
+
+            auto doubleIn = layouts.getChannelSet (true, doubleInputBus + i);
+            auto doubleOut = layouts.getChannelSet (false, doubleOutputBus + i);
+
+            if (doubleIn != doubleOut || ! (doubleIn.isDisabled() || doubleIn == juce::AudioChannelSet::stereo()))
+                return false;
+        }
+
         return true;
     }
 
@@ -107,60 +184,91 @@ public:
         for (auto i = totalNumInputChannels; i < totalNumOutputChannels; ++i)
             buffer.clear (i, 0, buffer.getNumSamples());
 
-        // Sidechain access
+        // Sidechain access, only while the host has the bus enabled and connected
         auto sidechainBuffer = getBusBuffer (buffer, true, 1);
+        auto* sidechainBus = getBus (true, 1);
+        const auto* sidechain = (sidechainBus != nullptr && sidechainBus->isEnabled() && sidechainBuffer.getNumChannels() > 0)
+                                    ? &sidechainBuffer : nullptr;
 
         updateParameters();
 
-        // "The Muscle" - Store dry signal
-        int numSamples = buffer.getNumSamples();
-        for (int i = 0; i < totalNumOutputChannels; ++i)
-            dryBuffer.copyFrom(i, 0, buffer.getReadPointer(i), numSamples);
-
-        // 1. Analyze the pressure (with Sidechain support)
-        pressureDetector.process(buffer, &sidechainBuffer);
-
-        // 2. Process through the module chain
-        if (! *apvts.getRawParameterValue ("bypass_dyn"))
-            dynamicsModule.process(buffer, pressureDetector);
-
-        if (! *apvts.getRawParameterValue ("bypass_eq"))
-            eqModule.process(buffer, pressureDetector);
+        // Silent input and every tail decayed: skip the chain and stay silent
+        if (! silenceGate.shouldProcess(buffer))
+        {
+            buffer.clear();
+            pushTelemetry(buffer);
+            return;
+        }
 
-        if (! *apvts.getRawParameterValue ("bypass_harm"))
-            harmonicsModule.process(buffer, pressureDetector);
+        // The lead's output channels only; the buffer also carries the sidechain and
+        // double buses. In mono-to-stereo mode the detector sees channel 0 alone.
+        const int numSamples = buffer.getNumSamples();
+        juce::AudioBuffer<float> main (buffer.getArrayOfWritePointers(), getMainBusNumOutputChannels(), numSamples);
+        juce::AudioBuffer<float> lead (buffer.getArrayOfWritePointers(), keyChannels, numSamples);
+
+        // 1. Analyze the pressure once for every bus, on the lead or on the sum of all
+        // buses (with Sidechain support). Offline bounces keep the analysis inline so
+        // renders are repeatable.
+        pressureDetector.setUseWorkerPool(! isNonRealtime());
+
+        juce::AudioBuffer<float> key (keyChannelPointers.data(), keyChannels, numSamples);
+        const bool summedKey = numDoubles > 0 && *apvts.getRawParameterValue ("bus_key") > 0.5f;
+        if (summedKey)
+            buildSummedKey(buffer, lead, key);
+
+        const auto& analysisInput = summedKey ? key : lead;
+
+        // A subscribed instance follows its publisher's pressure while the link is live.
+        // Offline the link is ignored: other tracks may not be rendering alongside this one.
+        const auto position = getTimelinePosition();
+        pressureLink.setRoute(isNonRealtime() ? PressureLinkPort::linkOff : (PressureLinkPort::Mode) (int) *apvts.getRawParameterValue ("link_mode"),
+                              (int) *apvts.getRawParameterValue ("link_id"));
+
+        if (auto* linked = pressureLink.receive(position, getSampleRate()))
+            pressureDetector.processLinked(analysisInput, sidechain, linked->intensity, linked->density, linked->timbre);
+        else
+            pressureDetector.process(analysisInput, sidechain);
+
+        pressureLink.publish(pressureDetector.getIntensity(), pressureDetector.getDensity(), pressureDetector.getTimbre(),
+                             position, getSampleRate());
+
+        // 2. Each bus through its own chain, all following the one detector
+        auto switches = getSwitches();
+        chains[0].process(main, pressureDetector, switches, settings);
+
+        // A double's output channels sit at or below its input's in the buffer, over the
+        // sidechain or the previous double's input; both are consumed by the time it runs.
+        for (int i = 0; i < maxDoubles; ++i)
+        {
+            if (! doubleActive[(size_t) i])
+                continue;
 
-        if (! *apvts.getRawParameterValue ("bypass_shift"))
-            shiftModule.process(buffer, pressureDetector);
+            auto in = getBusBuffer (buffer, true, doubleInputBus + i);
+            auto out = getBusBuffer (buffer, false, doubleOutputBus + i);
 
-        if (! *apvts.getRawParameterValue ("bypass_space"))
-            spaceModule.process(buffer, pressureDetector);
+            for (int channel = 0; channel < out.getNumChannels(); ++channel)
+                if (out.getWritePointer(channel) != in.getReadPointer(channel))
+                    out.copyFrom(channel, 0, in, channel, 0, numSamples);
 
-        // 3. New Features: The Void and The Wall
-        widenerModule.process(buffer, pressureDetector, *apvts.getRawParameterValue("void_width"));
-
-        // Parallel Blend (The Muscle)
-        float mix = *apvts.getRawParameterValue("muscle");
-        for (int channel = 0; channel < totalNumOutputChannels; ++channel)
-        {
-            auto* dryData = dryBuffer.getReadPointer(channel);
-            auto* wetData = buffer.getWritePointer(channel);
-            for (int sample = 0; sample < numSamples; ++sample)
-                wetData[sample] = dryData[sample] * (1.0f - mix) + wetData[sample] * mix;
+            chains[(size_t) (1 + i)].process(out, pressureDetector, switches, settings);
         }
 
-        clipperModule.process(buffer, *apvts.getRawParameterValue("wall_drive"), *apvts.getRawParameterValue("wall_ceil"));
-
-        // Update level for the meter
-        float maxLevel = 0.0f;
-        for (int channel = 0; channel < buffer.getNumChannels(); ++channel)
-            maxLevel = std::max(maxLevel, buffer.getMagnitude(channel, 0, buffer.getNumSamples()));
+        meteringEngine.process(main);
 
-        lastLevel.set(maxLevel);
+        juce::AudioBuffer<float> outputs (buffer.getArrayOfWritePointers(), totalNumOutputChannels, numSamples);
+        silenceGate.outputProcessed(outputs);
+        pushTelemetry(main);
     }
 
-    float getCurrentLevel() const { return lastLevel.get(); }
-    const PressureDetector& getPressureDetector() const { return pressureDetector; }
+    // Message thread: captures the current parameters, as RackSettings, into an A/B slot
+    void storePresetSlot(PresetSlots::Slot slot) { presetSlots.store(slot, RackSettings::fromParameters(apvts)); }
+    bool isPresetSlotStored(PresetSlots::Slot slot) const { return presetSlots.isStored(slot); }
+
+    // Working memory of this instance's scratch arena, in bytes
+    size_t getScratchFootprintBytes() const { return scratchArena.getFootprintBytes(); }
+
+    // Message thread only: takes the oldest unread block of telemetry
+    bool popTelemetry(TelemetryFrame& frame) { return telemetry.pop(frame); }
 
     //==============================================================================
     juce::AudioProcessorEditor* createEditor() override;
@@ -170,7 +278,7 @@ public:
     bool acceptsMidi() const override                            { return false; }
     bool producesMidi() const override                           { return false; }
     bool isMidiEffect() const override                           { return false; }
-    double getTailLengthSeconds() const override                 { return 0.0; }
+    double getTailLengthSeconds() const override                 { return tailSeconds.load(); }
 
     int getNumPrograms() override                                { return 1; }
     int getCurrentProgram() override                             { return 0; }
@@ -180,13 +288,19 @@ public:
 
     void getStateInformation (juce::MemoryBlock& destData) override
     {
-        auto state = apvts.copyState();
-        std::unique_ptr<juce::XmlElement> xml (state.createXml());
-        copyXmlToBinary (*xml, destData);
+        stateCodec.write (destData, presetSlots);
     }
 
     void setStateInformation (const void* data, int sizeInBytes) override
     {
+        if (stateCodec.read (data, sizeInBytes, presetSlots))
+            return;
+
+        // Sessions saved before the binary format carry the parameter tree as XML, and
+        // no A/B slots
+        presetSlots.clear (PresetSlots::slotA);
+        presetSlots.clear (PresetSlots::slotB);
+
         std::unique_ptr<juce::XmlElement> xmlState (getXmlFromBinary (data, sizeInBytes));
         if (xmlState.get() != nullptr)
             if (xmlState->hasTagName (apvts.state.getType()))
@@ -196,44 +310,208 @@ public:
     juce::AudioProcessorValueTreeState apvts;
 
 private:
+    BinaryStateCodec stateCodec;
+
     void updateParameters()
     {
-        // Master INTENSITY controls the range and depth of all reactive components.
-        // At 0% (0.0), it provides a controlled shaper.
-        // At 100% (1.0), it pushes everything into "monster" territory.
-        float m = *apvts.getRawParameterValue ("intensity");
-        float aggressionScale = 0.4f + (m * 1.6f); // 0.4x to 2.0x range
+        // With A/B engaged the stages follow the morph between the two stored slots;
+        // otherwise the live parameters
+        presetSlots.pull(slotSettings);
+
+        if (*apvts.getRawParameterValue ("ab_enabled") && presetSlots.isStored(PresetSlots::slotA) && presetSlots.isStored(PresetSlots::slotB))
+            settings = RackSettings::interpolate(slotSettings[PresetSlots::slotA], slotSettings[PresetSlots::slotB],
+                                                 *apvts.getRawParameterValue ("ab_morph"));
+        else
+            settings = RackSettings::fromParameters(apvts);
+
+        for (auto& chain : chains)
+            chain.applySettings(settings);
+
+        updateTailLength();
+    }
+
+    RackChain::Switches getSwitches() const
+    {
+        RackChain::Switches switches;
+        switches.dynamics  = ! *apvts.getRawParameterValue ("bypass_dyn");
+        switches.eq        = ! *apvts.getRawParameterValue ("bypass_eq");
+        switches.harmonics = ! *apvts.getRawParameterValue ("bypass_harm");
+        switches.shift     = ! *apvts.getRawParameterValue ("bypass_shift");
+        switches.space     = ! *apvts.getRawParameterValue ("bypass_space");
+        return switches;
+    }
+
+    // Latency plus the reverb's decay, which is the only stage that rings on
+    void updateTailLength()
+    {
+        double tail = getSampleRate() > 0.0 ? (double) getLatencySamples() / getSampleRate() : 0.0;
+        if (! *apvts.getRawParameterValue ("bypass_space"))
+            tail += chains[0].getReverbTailSeconds();
+        tailSeconds.store(tail);
+    }
 
-        dynamicsModule.functionAmount = juce::jlimit(0.0f, 1.0f, (float)*apvts.getRawParameterValue ("dyn_amount") * aggressionScale);
-        dynamicsModule.sustainCut     = juce::jlimit(0.0f, 1.0f, (float)*apvts.getRawParameterValue ("dyn_sustain") * aggressionScale);
+    // Host timeline position of this block in samples, or -1 if the host doesn't say
+    juce::int64 getTimelinePosition() const
+    {
+        if (auto* playHead = getPlayHead())
+            if (auto position = playHead->getPosition())
+                if (auto samples = position->getTimeInSamples())
+                    return *samples;
 
-        eqModule.scoopAmount = juce::jlimit(0.0f, 1.0f, (float)*apvts.getRawParameterValue ("eq_scoop") * aggressionScale);
-        eqModule.biteAmount  = juce::jlimit(0.0f, 1.0f, (float)*apvts.getRawParameterValue ("eq_bite") * aggressionScale);
+        return -1;
+    }
 
-        harmonicsModule.gritAmount    = juce::jlimit(0.0f, 1.0f, (float)*apvts.getRawParameterValue ("harm_grit") * aggressionScale);
-        harmonicsModule.clarityAmount = juce::jlimit(0.0f, 1.0f, (float)*apvts.getRawParameterValue ("harm_clarity") * aggressionScale);
+    // The lead's input plus every double's, folded to the detector's width
+    void buildSummedKey(juce::AudioBuffer<float>& buffer, const juce::AudioBuffer<float>& lead, juce::AudioBuffer<float>& key)
+    {
+        const int numSamples = key.getNumSamples();
 
-        // Pitch/Formant shifts become much more extreme as intensity rises
-        float shiftScale = 1.0f + (m * 2.0f); // 1x to 3x sensitivity
-        shiftModule.pitchShift   = (*apvts.getRawParameterValue ("shift_pitch") - 0.5f) * 24.0f * shiftScale;
-        shiftModule.formantShift = (*apvts.getRawParameterValue ("shift_formant") - 0.5f) * 24.0f * shiftScale;
+        for (int channel = 0; channel < keyChannels; ++channel)
+            key.copyFrom(channel, 0, lead, channel, 0, numSamples);
 
-        spaceModule.mixAmount       = juce::jlimit(0.0f, 1.0f, (float)*apvts.getRawParameterValue ("space_mix") * aggressionScale);
-        spaceModule.characterAmount = juce::jlimit(0.0f, 1.0f, (float)*apvts.getRawParameterValue ("space_char") * aggressionScale);
+        for (int i = 0; i < maxDoubles; ++i)
+        {
+            if (! doubleActive[(size_t) i])
+                continue;
+
+            auto in = getBusBuffer (buffer, true, doubleInputBus + i);
+
+            if (in.getNumChannels() == keyChannels)
+            {
+                for (int channel = 0; channel < keyChannels; ++channel)
+                    key.addFrom(channel, 0, in, channel, 0, numSamples);
+            }
+            else
+            {
+                const float gain = 1.0f / (float) in.getNumChannels();
+                for (int channel = 0; channel < in.getNumChannels(); ++channel)
+                    for (int keyChannel = 0; keyChannel < keyChannels; ++keyChannel)
+                        key.addFrom(keyChannel, 0, in, channel, 0, numSamples, gain);
+            }
+        }
+    }
+
+    // Where each scratch buffer is live in processBlock. The chains follow the detector
+    // one after another, each taking RackChain::numStages stages.
+    enum ProcessStage
+    {
+        stageKey = 0,
+        stageDetector,
+        stageFirstChain
+    };
+
+    void prepareScratch(const juce::dsp::ProcessSpec& keySpec)
+    {
+        const int blockSize = (int) keySpec.maximumBlockSize;
+
+        scratchArena.beginPlan();
+        auto key = scratchArena.reserve((size_t) (keyChannels * blockSize), stageKey, stageDetector);
+
+        // Only the analysis itself reads the detector's scratch
+        auto detector = scratchArena.reserve(PressureDetector::getScratchSize(keySpec), stageDetector, stageDetector);
+
+        int firstStage = stageFirstChain;
+        for (size_t i = 0; i < chains.size(); ++i)
+        {
+            if (i == 0 || doubleActive[i - 1])
+            {
+                chains[i].reserveScratch(scratchArena, firstStage);
+                firstStage += RackChain::numStages;
+            }
+        }
+
+        scratchArena.allocate();
+
+        keyChannelPointers.resize((size_t) keyChannels);
+        for (int channel = 0; channel < keyChannels; ++channel)
+            keyChannelPointers[(size_t) channel] = scratchArena.get(key) + (size_t) (channel * blockSize);
+
+        pressureDetector.setScratch(scratchArena.get(detector));
+
+        for (size_t i = 0; i < chains.size(); ++i)
+            if (i == 0 || doubleActive[i - 1])
+                chains[i].setScratch(scratchArena);
+    }
+
+    void pushTelemetry(const juce::AudioBuffer<float>& buffer)
+    {
+        const auto& lead = chains[0];
+
+        TelemetryFrame frame;
+        frame.blockIndex = telemetryBlockIndex++;
+        frame.numSamples = buffer.getNumSamples();
+        frame.numChannels = juce::jmin(buffer.getNumChannels(), meteringEngine.getNumChannels(), TelemetryFrame::maxChannels);
+
+        frame.intensity = pressureDetector.getIntensity();
+        frame.density = pressureDetector.getDensity();
+        frame.timbre = pressureDetector.getTimbre();
+        frame.pitchHz = pressureDetector.getPitchHz();
+        frame.pitchConfidence = pressureDetector.getPitchConfidence();
+        frame.transient = pressureDetector.getTransientStrength();
+
+        const int numSpectralFrames = pressureDetector.getNumSpectralFramesThisBlock();
+        for (int f = 0; f < numSpectralFrames; ++f)
+        {
+            const auto& spectral = pressureDetector.getSpectralFrame(f);
+            frame.spectralCentroidHz += spectral.centroidHz / (float) numSpectralFrames;
+            frame.spectralFlatness += spectral.flatness / (float) numSpectralFrames;
+        }
+
+        if (numSpectralFrames == 0 && pressureDetector.getSpectralFrame().frameIndex > 0)
+        {
+            frame.spectralCentroidHz = pressureDetector.getSpectralFrame().centroidHz;
+            frame.spectralFlatness = pressureDetector.getSpectralFrame().flatness;
+        }
+
+        for (int channel = 0; channel < frame.numChannels; ++channel)
+        {
+            frame.peak[(size_t) channel] = meteringEngine.getPeak(channel);
+            frame.truePeak[(size_t) channel] = meteringEngine.getTruePeak(channel);
+            frame.rms[(size_t) channel] = meteringEngine.getRMS(channel);
+        }
+
+        const auto& loudness = lead.getMakeupGain().getStageMeter();
+        frame.momentaryLUFS = loudness.getMomentaryLUFS();
+        frame.shortTermLUFS = loudness.getShortTermLUFS();
+        frame.integratedLUFS = loudness.getIntegratedLUFS();
+        frame.makeupGainDb = lead.getMakeupGain().getGainDb();
+
+        frame.setGainReductionDb(TelemetryStage::dynamics, *apvts.getRawParameterValue ("bypass_dyn") ? 0.0f : lead.getDynamics().getGainReductionDb());
+        frame.setGainReductionDb(TelemetryStage::deReverb, lead.getDynamics().getDeReverbReductionDb());
+        frame.setGainReductionDb(TelemetryStage::tame, lead.getHarshness().getGainReductionDb());
+        frame.setGainReductionDb(TelemetryStage::wall, lead.getClipper().getGainReductionDb());
+
+        frame.eqRecomputes = lead.getEQ().getRecomputeCount();
+        frame.spaceRecomputes = lead.getSpace().getRecomputeCount();
+        frame.shiftRecomputes = lead.getShift().getRecomputeCount();
+
+        telemetry.push(frame);
     }
 
     //==============================================================================
-    PressureDetector pressureDetector;
-    DynamicsModule   dynamicsModule;
-    EQModule         eqModule;
-    HarmonicsModule  harmonicsModule;
-    ShiftModule      shiftModule;
-    SpaceModule      spaceModule;
-    WidenerModule    widenerModule;
-    ClipperModule    clipperModule;
-
-    juce::AudioBuffer<float> dryBuffer;
-    juce::Atomic<float> lastLevel { 0.0f };
+    // Bus indices of the first double; input bus 1 is the sidechain
+    static constexpr int doubleInputBus = 2, doubleOutputBus = 1;
+
+    PressureDetector pressureDetector; // Shared by every bus
+    PressureLinkPort pressureLink;
+    std::array<RackChain, 1 + maxDoubles> chains; // Lead first, then the doubles
+    std::array<bool, maxDoubles> doubleActive {};
+    int numDoubles = 0;
+    MeteringEngine   meteringEngine;
+
+    ScratchArena scratchArena;
+    std::vector<float*> keyChannelPointers; // Summed key, in scratch memory
+    int keyChannels = 2;
+
+    SilenceGate silenceGate;
+
+    PresetSlots presetSlots;
+    std::array<RackSettings, PresetSlots::numSlots> slotSettings; // Audio thread's copies
+    RackSettings settings;                                        // What the stages run with this block
+    std::atomic<double> tailSeconds { 0.0 };
+
+    TelemetryFifo<256> telemetry;
+    juce::uint64 telemetryBlockIndex = 0;
 
     //==============================================================================
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (VocalAggressorRack)
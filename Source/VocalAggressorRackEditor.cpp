@@ -9,9 +9,47 @@
 #include "VocalAggressorRackEditor.h"
 #include "VocalAggressorRack.h"
 
-LevelMeter::LevelMeter(VocalAggressorRack& p) : processor(p)
+int LevelMeter::levelToY(float level) const
 {
-    startTimerHz(30);
+    float db = juce::Decibels::gainToDecibels(level);
+    float height = juce::jlimit(0.0f, (float) getHeight(), juce::jmap(db, -60.0f, 0.0f, 0.0f, (float) getHeight()));
+    return getHeight() - juce::roundToInt(height);
+}
+
+void LevelMeter::update()
+{
+    if (trail.size() == 0)
+        return;
+
+    // True-peak hold across the whole trail, so inter-sample overs between repaints aren't missed
+    float held = 0.0f;
+    for (int i = 0; i < trail.size(); ++i)
+        held = juce::jmax(held, trail[i].getMaxTruePeak());
+
+    float level = trail.getLatest().getMaxPeak();
+    float db = juce::Decibels::gainToDecibels(level);
+    int zone = db > -1.0f ? 2 : (db > -6.0f ? 1 : 0);
+    int levelY = levelToY(level);
+    int holdY = levelToY(held);
+
+    if (levelY == shownLevelY && holdY == shownHoldY && zone == shownZone)
+        return;
+
+    if (zone != shownZone || shownLevelY < 0)
+    {
+        repaint();
+    }
+    else
+    {
+        int top = juce::jmin(levelY, shownLevelY);
+        repaint(0, top, getWidth(), std::abs(levelY - shownLevelY) + 1);
+        repaint(0, holdY - 1, getWidth(), 3);
+        repaint(0, shownHoldY - 1, getWidth(), 3);
+    }
+
+    shownLevelY = levelY;
+    shownHoldY = holdY;
+    shownZone = zone;
 }
 
 void LevelMeter::paint(juce::Graphics& g)
@@ -20,43 +58,108 @@ void LevelMeter::paint(juce::Graphics& g)
     g.setColour(juce::Colours::black);
     g.fillRect(bounds);
 
-    float level = processor.getCurrentLevel();
-    float db = juce::Decibels::gainToDecibels(level);
-    float height = juce::jmap(db, -60.0f, 0.0f, 0.0f, bounds.getHeight());
+    if (shownLevelY < 0)
+        return;
 
     g.setColour(juce::Colours::green.withAlpha(0.8f));
-    if (db > -6.0f) g.setColour(juce::Colours::yellow.withAlpha(0.8f));
-    if (db > -1.0f) g.setColour(juce::Colours::red.withAlpha(0.8f));
+    if (shownZone == 1) g.setColour(juce::Colours::yellow.withAlpha(0.8f));
+    if (shownZone == 2) g.setColour(juce::Colours::red.withAlpha(0.8f));
 
-    g.fillRect(bounds.withTop(bounds.getHeight() - height));
+    g.fillRect(bounds.withTop((float) shownLevelY));
+
+    g.setColour(juce::Colours::white.withAlpha(0.7f));
+    g.fillRect(bounds.getX(), (float) shownHoldY, bounds.getWidth(), 1.0f);
 }
 
-void PressureMap::paint(juce::Graphics& g)
+juce::Point<float> PressureMap::toPoint(const TelemetryFrame& frame) const
 {
-    auto bounds = getLocalBounds().toFloat();
-    g.setColour(juce::Colours::black.withAlpha(0.5f));
-    g.fillRoundedRectangle(bounds, 5.0f);
-
-    const auto& detector = processor.getPressureDetector();
-    float intensity = detector.getIntensity();
-    float density = detector.getDensity();
-    float timbre = detector.getTimbre();
-
     // Draw a 2D map: Intensity (X) vs Density (Y)
-    g.setColour(juce::Colours::orange);
-    float x = juce::jmap(intensity, 0.0f, 1.0f, 15.0f, bounds.getWidth() - 15.0f);
-    float y = juce::jmap(density, 0.0f, 1.0f, bounds.getHeight() - 15.0f, 15.0f);
+    return { juce::jmap(frame.intensity, 0.0f, 1.0f, 15.0f, (float) getWidth() - 15.0f),
+             juce::jmap(frame.density, 0.0f, 1.0f, (float) getHeight() - 15.0f, 15.0f) };
+}
 
-    // Circle size morphs with Timbre (Harshness)
-    float radius = 4.0f + timbre * 10.0f;
-    g.fillEllipse(x - radius, y - radius, radius * 2.0f, radius * 2.0f);
+juce::Rectangle<int> PressureMap::getTrailBounds() const
+{
+    juce::Rectangle<float> area;
+    for (int i = 0; i < trail.size(); ++i)
+    {
+        auto p = toPoint(trail[i]);
+        area = i == 0 ? juce::Rectangle<float>(p, p) : area.getUnion(juce::Rectangle<float>(p, p));
+    }
+
+    // Room for the largest marker and its halo
+    return area.expanded(20.0f).getSmallestIntegerContainer();
+}
 
-    g.setColour(juce::Colours::orange.withAlpha(0.2f));
-    g.drawEllipse(x - radius - 5, y - radius - 5, (radius + 5) * 2.0f, (radius + 5) * 2.0f, 1.0f);
+void PressureMap::update()
+{
+    if (trail.size() == 0)
+        return;
+
+    // Cheap fingerprint of everything drawn; a held note that doesn't move costs nothing
+    float signature = 0.0f;
+    for (int i = 0; i < trail.size(); ++i)
+    {
+        auto p = toPoint(trail[i]);
+        signature += p.x * (float) (i + 1) + p.y * (float) (i + 7);
+    }
+    signature += trail.getLatest().timbre * 1000.0f;
+
+    if (signature == shownSignature)
+        return;
+
+    auto bounds = getTrailBounds();
+    repaint(bounds.getUnion(shownBounds));
+
+    shownBounds = bounds;
+    shownSignature = signature;
+}
 
-    g.setColour(juce::Colours::white.withAlpha(0.5f));
-    g.setFont(10.0f);
-    g.drawText("PRESSURE MAP", bounds.reduced(5), juce::Justification::bottomLeft);
+void PressureMap::paint(juce::Graphics& g)
+{
+    auto bounds = getLocalBounds().toFloat();
+    float scale = g.getInternalContext().getPhysicalPixelScaleFactor();
+
+    // Static backdrop, rendered once per size
+    if (background.isNull() || background.getWidth() != juce::roundToInt(bounds.getWidth() * scale))
+    {
+        background = juce::Image(juce::Image::ARGB, juce::jmax(1, juce::roundToInt(bounds.getWidth() * scale)),
+                                 juce::jmax(1, juce::roundToInt(bounds.getHeight() * scale)), true);
+
+        juce::Graphics bg(background);
+        bg.addTransform(juce::AffineTransform::scale(scale));
+        bg.setColour(juce::Colours::black.withAlpha(0.5f));
+        bg.fillRoundedRectangle(bounds, 5.0f);
+
+        bg.setColour(juce::Colours::white.withAlpha(0.5f));
+        bg.setFont(10.0f);
+        bg.drawText("PRESSURE MAP", bounds.reduced(5), juce::Justification::bottomLeft);
+    }
+
+    g.drawImage(background, bounds);
+
+    // Trail of recent blocks, fading with age
+    for (int i = 0; i < trail.size() - 1; ++i)
+    {
+        float age = (float) (i + 1) / (float) trail.size();
+        auto p = toPoint(trail[i]);
+        g.setColour(juce::Colours::orange.withAlpha(0.35f * age));
+        g.fillEllipse(p.x - 2.0f, p.y - 2.0f, 4.0f, 4.0f);
+    }
+
+    if (trail.size() > 0)
+    {
+        const auto& latest = trail.getLatest();
+        auto p = toPoint(latest);
+
+        // Circle size morphs with Timbre (Harshness)
+        float radius = 4.0f + latest.timbre * 10.0f;
+        g.setColour(juce::Colours::orange);
+        g.fillEllipse(p.x - radius, p.y - radius, radius * 2.0f, radius * 2.0f);
+
+        g.setColour(juce::Colours::orange.withAlpha(0.2f));
+        g.drawEllipse(p.x - radius - 5, p.y - radius - 5, (radius + 5) * 2.0f, (radius + 5) * 2.0f, 1.0f);
+    }
 }
 
 VocalAggressorRackEditor::VocalAggressorRackEditor (VocalAggressorRack& p)
@@ -71,8 +174,8 @@ VocalAggressorRackEditor::VocalAggressorRackEditor (VocalAggressorRack& p)
       shiftCable(p.apvts, "bypass_shift"),
       spaceModule("SPACE", p.apvts, "bypass_space"),
       spaceCable(p.apvts, "bypass_space"),
-      meter(p),
-      pressureMap(p)
+      meter(telemetryTrail),
+      pressureMap(telemetryTrail)
 {
     auto setupSlider = [this](juce::Slider& s, juce::Label& l, const juce::String& name) {
         s.setSliderStyle(juce::Slider::RotaryHorizontalVerticalDrag);
@@ -107,10 +210,13 @@ VocalAggressorRackEditor::VocalAggressorRackEditor (VocalAggressorRack& p)
     setupSlider(eqBiteSlider, eqBiteLabel, "Bite");
     eqModule.addControl(eqScoopSlider, eqScoopLabel);
     eqModule.addControl(eqBiteSlider, eqBiteLabel);
+    setupSlider(eqTameSlider, eqTameLabel, "Tame");
+    eqModule.addControl(eqTameSlider, eqTameLabel);
     addAndMakeVisible(eqModule);
     addAndMakeVisible(eqCable);
     eqScoopAttach = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(audioProcessor.apvts, "eq_scoop", eqScoopSlider);
     eqBiteAttach = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(audioProcessor.apvts, "eq_bite", eqBiteSlider);
+    eqTameAttach = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(audioProcessor.apvts, "eq_tame", eqTameSlider);
 
     // Harmonics
     setupSlider(harmGritSlider, harmGritLabel, "Grit");
@@ -127,10 +233,16 @@ VocalAggressorRackEditor::VocalAggressorRackEditor (VocalAggressorRack& p)
     setupSlider(shiftFormantSlider, shiftFormantLabel, "Formant");
     shiftModule.addControl(shiftPitchSlider, shiftPitchLabel);
     shiftModule.addControl(shiftFormantSlider, shiftFormantLabel);
+    setupSlider(shiftVoicesSlider, shiftVoicesLabel, "Voices");
+    setupSlider(shiftSpreadSlider, shiftSpreadLabel, "Spread");
+    shiftModule.addControl(shiftVoicesSlider, shiftVoicesLabel);
+    shiftModule.addControl(shiftSpreadSlider, shiftSpreadLabel);
     addAndMakeVisible(shiftModule);
     addAndMakeVisible(shiftCable);
     shiftPitchAttach = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(audioProcessor.apvts, "shift_pitch", shiftPitchSlider);
     shiftFormantAttach = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(audioProcessor.apvts, "shift_formant", shiftFormantSlider);
+    shiftVoicesAttach = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(audioProcessor.apvts, "shift_voices", shiftVoicesSlider);
+    shiftSpreadAttach = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(audioProcessor.apvts, "shift_spread", shiftSpreadSlider);
 
     // Space
     setupSlider(spaceMixSlider, spaceMixLabel, "Mix");
@@ -164,13 +276,68 @@ VocalAggressorRackEditor::VocalAggressorRackEditor (VocalAggressorRack& p)
     addAndMakeVisible(wallCeilLabel);
     wallCeilAttach = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(audioProcessor.apvts, "wall_ceil", wallCeilSlider);
 
+    // Loudness makeup ahead of The Wall
+    setupSlider(makeupTargetSlider, makeupLabel, "LOUD");
+    makeupModeBox.addItemList({ "Off", "Match Input", "Target" }, 1);
+    addAndMakeVisible(makeupModeBox);
+    addAndMakeVisible(makeupTargetSlider);
+    addAndMakeVisible(makeupLabel);
+    makeupModeAttach = std::make_unique<juce::AudioProcessorValueTreeState::ComboBoxAttachment>(audioProcessor.apvts, "makeup_mode", makeupModeBox);
+    makeupTargetAttach = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(audioProcessor.apvts, "makeup_target", makeupTargetSlider);
+
+    // A/B slots: store the current settings into a slot, then morph between them
+    storeAButton.setButtonText("STORE A");
+    storeBButton.setButtonText("STORE B");
+    storeAButton.onClick = [this] { audioProcessor.storePresetSlot(PresetSlots::slotA); };
+    storeBButton.onClick = [this] { audioProcessor.storePresetSlot(PresetSlots::slotB); };
+    abToggle.setButtonText("A/B");
+    abMorphSlider.setSliderStyle(juce::Slider::LinearHorizontal);
+    abMorphSlider.setTextBoxStyle(juce::Slider::NoTextBox, false, 0, 0);
+    addAndMakeVisible(storeAButton);
+    addAndMakeVisible(storeBButton);
+    addAndMakeVisible(abToggle);
+    addAndMakeVisible(abMorphSlider);
+    abEnabledAttach = std::make_unique<juce::AudioProcessorValueTreeState::ButtonAttachment>(audioProcessor.apvts, "ab_enabled", abToggle);
+    abMorphAttach = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(audioProcessor.apvts, "ab_morph", abMorphSlider);
+
     addAndMakeVisible(meter);
     addAndMakeVisible(pressureMap);
 
     setSize (500, 850);
+
+    // Every open editor shares one display-synced clock rather than running its own timer
+    animationClock->subscribe(*this, *this);
 }
 
-VocalAggressorRackEditor::~VocalAggressorRackEditor() {}
+VocalAggressorRackEditor::~VocalAggressorRackEditor()
+{
+    animationClock->unsubscribe(*this);
+}
+
+void VocalAggressorRackEditor::animationTick()
+{
+    TelemetryFrame frame;
+    bool received = false;
+
+    while (audioProcessor.popTelemetry(frame))
+    {
+        telemetryTrail.add(frame);
+        received = true;
+    }
+
+    // Each display repaints only what moved; with no audio nothing is repainted at all
+    if (received)
+    {
+        meter.update();
+        pressureMap.update();
+    }
+
+    for (auto* module : { &dynModule, &eqModule, &harmModule, &shiftModule, &spaceModule })
+        module->refreshBypassState();
+
+    for (auto* cable : { &dynCable, &eqCable, &harmCable, &shiftCable, &spaceCable })
+        cable->refreshBypassState();
+}
 
 void VocalAggressorRackEditor::paint (juce::Graphics& g)
 {
@@ -205,21 +372,32 @@ void VocalAggressorRackEditor::resized()
     muscleLabel.setBounds(leftHeader.removeFromTop(20));
     muscleSlider.setBounds(leftHeader.reduced(5));
 
+    auto abArea = headerArea.removeFromBottom(24).reduced(10, 0);
+    storeAButton.setBounds(abArea.removeFromLeft(56));
+    abToggle.setBounds(abArea.removeFromLeft(48).reduced(4, 0));
+    storeBButton.setBounds(abArea.removeFromRight(56));
+    abMorphSlider.setBounds(abArea);
+
     pressureMap.setBounds(headerArea.reduced(10));
 
     // Footer: The Wall and The Void
     auto footerArea = mainArea.removeFromBottom(100);
-    auto f1 = footerArea.removeFromLeft(footerArea.getWidth() / 3);
+    auto f1 = footerArea.removeFromLeft(footerArea.getWidth() / 4);
     voidWidthLabel.setBounds(f1.removeFromTop(20));
     voidWidthSlider.setBounds(f1.reduced(5));
 
-    auto f2 = footerArea.removeFromLeft(footerArea.getWidth() / 2);
-    wallDriveLabel.setBounds(f2.removeFromTop(20));
-    wallDriveSlider.setBounds(f2.reduced(5));
+    auto f2 = footerArea.removeFromLeft(footerArea.getWidth() / 3);
+    makeupLabel.setBounds(f2.removeFromTop(20));
+    makeupModeBox.setBounds(f2.removeFromBottom(22).reduced(2, 0));
+    makeupTargetSlider.setBounds(f2.reduced(5));
+
+    auto f3 = footerArea.removeFromLeft(footerArea.getWidth() / 2);
+    wallDriveLabel.setBounds(f3.removeFromTop(20));
+    wallDriveSlider.setBounds(f3.reduced(5));
 
-    auto f3 = footerArea;
-    wallCeilLabel.setBounds(f3.removeFromTop(20));
-    wallCeilSlider.setBounds(f3.reduced(5));
+    auto f4 = footerArea;
+    wallCeilLabel.setBounds(f4.removeFromTop(20));
+    wallCeilSlider.setBounds(f4.reduced(5));
 
     // Modules stacked vertically
     int moduleHeight = mainArea.getHeight() / 5;
@@ -9,9 +9,14 @@
 #pragma once
 
 #include <JuceHeader.h>
+#include "Telemetry.h"
+#include "AnimationClock.h"
 
 class VocalAggressorRack; // Forward declaration
 
+// Recent blocks of telemetry, drained from the processor by the editor's timer
+using TelemetryTrail = TelemetryHistory<64>;
+
 //==============================================================================
 class PatchCable : public juce::Component
 {
@@ -20,11 +25,21 @@ public:
         : apvts(vts), id(paramID)
     {
         setInterceptsMouseClicks(true, false);
+
+        // Static artwork: only re-rendered when the bypass state flips
+        setBufferedToImage(true);
+    }
+
+    // Picks up bypass changes made by the host or a preset
+    void refreshBypassState()
+    {
+        if (isBypassed() != shownBypassed)
+            repaint();
     }
 
     void paint(juce::Graphics& g) override
     {
-        bool bypassed = *apvts.getRawParameterValue(id) > 0.5f;
+        bool bypassed = shownBypassed = isBypassed();
 
         g.setColour(bypassed ? juce::Colours::grey : juce::Colours::red.darker(0.2f));
 
@@ -65,37 +80,51 @@ public:
     }
 
 private:
+    bool isBypassed() const { return *apvts.getRawParameterValue(id) > 0.5f; }
+
     juce::AudioProcessorValueTreeState& apvts;
     juce::String id;
+    bool shownBypassed = false;
 };
 
 //==============================================================================
-class PressureMap : public juce::Component, public juce::Timer
+class PressureMap : public juce::Component
 {
 public:
-    PressureMap(VocalAggressorRack& p) : processor(p)
-    {
-        startTimerHz(30);
-    }
+    PressureMap(const TelemetryTrail& t) : trail(t) {}
 
-    void paint(juce::Graphics& g) override;
+    // Repaints just the region the trail moved through, or nothing if it is still
+    void update();
 
-    void timerCallback() override { repaint(); }
+    void paint(juce::Graphics& g) override;
+    void resized() override { background = {}; }
 
 private:
-    VocalAggressorRack& processor;
+    juce::Point<float> toPoint(const TelemetryFrame& frame) const;
+    juce::Rectangle<int> getTrailBounds() const;
+
+    const TelemetryTrail& trail;
+    juce::Image background;
+    juce::Rectangle<int> shownBounds;
+    float shownSignature = -1.0f;
 };
 
 //==============================================================================
-class LevelMeter : public juce::Component, public juce::Timer
+class LevelMeter : public juce::Component
 {
 public:
-    LevelMeter(VocalAggressorRack& p);
+    LevelMeter(const TelemetryTrail& t) : trail(t) { setOpaque(true); }
+
+    // Repaints only the rows between the old and new bar and hold positions
+    void update();
+
     void paint(juce::Graphics& g) override;
-    void timerCallback() override { repaint(); }
 
 private:
-    VocalAggressorRack& processor;
+    int levelToY(float level) const;
+
+    const TelemetryTrail& trail;
+    int shownLevelY = -1, shownHoldY = -1, shownZone = -1;
 };
 
 //==============================================================================
@@ -108,31 +137,35 @@ public:
         setTextLabelPosition(juce::Justification::centredTop);
     }
 
-    void paint(juce::Graphics& g) override
+    // Picks up bypass changes made by the cable, the host or a preset
+    void refreshBypassState()
     {
-        auto bounds = getLocalBounds().toFloat();
-        bool bypassed = *apvts.getRawParameterValue(id) > 0.5f;
-
-        // Faceplate
-        g.setColour(juce::Colours::darkgrey.darker(0.5f));
-        g.fillRoundedRectangle(bounds.reduced(2), 4.0f);
-
-        if (bypassed)
-            g.setOpacity(0.3f);
-        else
-            g.setOpacity(1.0f);
+        if (isBypassed() != faceplateBypassed)
+        {
+            faceplate = {};
+            repaint();
+        }
+    }
 
-        g.setColour(juce::Colours::white.withAlpha(0.1f));
-        g.drawRoundedRectangle(bounds.reduced(2), 4.0f, 1.0f);
+    void paint(juce::Graphics& g) override
+    {
+        // The faceplate is static artwork, so it is rendered once per size and bypass state
+        float scale = g.getInternalContext().getPhysicalPixelScaleFactor();
+        bool bypassed = isBypassed();
 
-        juce::GroupComponent::paint(g);
+        if (faceplate.isNull() || bypassed != faceplateBypassed || scale != faceplateScale)
+        {
+            faceplateBypassed = bypassed;
+            faceplateScale = scale;
+            faceplate = juce::Image(juce::Image::ARGB, juce::jmax(1, juce::roundToInt((float) getWidth() * scale)),
+                                    juce::jmax(1, juce::roundToInt((float) getHeight() * scale)), true);
+
+            juce::Graphics fg(faceplate);
+            fg.addTransform(juce::AffineTransform::scale(scale));
+            paintFaceplate(fg, bypassed);
+        }
 
-        // Rack Screws
-        g.setColour(juce::Colours::grey);
-        g.fillEllipse(5, 5, 4, 4);
-        g.fillEllipse(bounds.getWidth() - 9, 5, 4, 4);
-        g.fillEllipse(5, bounds.getHeight() - 9, 4, 4);
-        g.fillEllipse(bounds.getWidth() - 9, bounds.getHeight() - 9, 4, 4);
+        g.drawImage(faceplate, getLocalBounds().toFloat());
     }
 
     void addControl(juce::Component& c, juce::Component& label)
@@ -145,6 +178,8 @@ public:
 
     void resized() override
     {
+        faceplate = {};
+
         auto area = getLocalBounds().reduced(10);
         area.removeFromTop(20); // Room for title
 
@@ -161,14 +196,47 @@ public:
     }
 
 private:
+    bool isBypassed() const { return *apvts.getRawParameterValue(id) > 0.5f; }
+
+    void paintFaceplate(juce::Graphics& g, bool bypassed)
+    {
+        auto bounds = getLocalBounds().toFloat();
+
+        // Faceplate
+        g.setColour(juce::Colours::darkgrey.darker(0.5f));
+        g.fillRoundedRectangle(bounds.reduced(2), 4.0f);
+
+        if (bypassed)
+            g.setOpacity(0.3f);
+        else
+            g.setOpacity(1.0f);
+
+        g.setColour(juce::Colours::white.withAlpha(0.1f));
+        g.drawRoundedRectangle(bounds.reduced(2), 4.0f, 1.0f);
+
+        juce::GroupComponent::paint(g);
+
+        // Rack Screws
+        g.setColour(juce::Colours::grey);
+        g.fillEllipse(5, 5, 4, 4);
+        g.fillEllipse(bounds.getWidth() - 9, 5, 4, 4);
+        g.fillEllipse(5, bounds.getHeight() - 9, 4, 4);
+        g.fillEllipse(bounds.getWidth() - 9, bounds.getHeight() - 9, 4, 4);
+    }
+
     juce::AudioProcessorValueTreeState& apvts;
     juce::String id;
     juce::Array<juce::Component*> controls;
     juce::Array<juce::Component*> labels;
+
+    juce::Image faceplate;
+    bool faceplateBypassed = false;
+    float faceplateScale = 1.0f;
 };
 
 //==============================================================================
-class VocalAggressorRackEditor  : public juce::AudioProcessorEditor
+class VocalAggressorRackEditor  : public juce::AudioProcessorEditor,
+                                  private AnimationClock::Listener
 {
 public:
     VocalAggressorRackEditor (VocalAggressorRack&);
@@ -178,7 +246,11 @@ public:
     void resized() override;
 
 private:
+    void animationTick() override;
+
     VocalAggressorRack& audioProcessor;
+    TelemetryTrail telemetryTrail;
+    juce::SharedResourcePointer<AnimationClock> animationClock;
 
     juce::Slider intensitySlider;
     juce::Label intensityLabel;
@@ -191,10 +263,10 @@ private:
     std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> dynAmountAttach, dynSustainAttach;
 
     RackModule eqModule;
-    juce::Slider eqScoopSlider, eqBiteSlider;
-    juce::Label eqScoopLabel, eqBiteLabel;
+    juce::Slider eqScoopSlider, eqBiteSlider, eqTameSlider;
+    juce::Label eqScoopLabel, eqBiteLabel, eqTameLabel;
     PatchCable eqCable;
-    std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> eqScoopAttach, eqBiteAttach;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> eqScoopAttach, eqBiteAttach, eqTameAttach;
 
     RackModule harmModule;
     juce::Slider harmGritSlider, harmClaritySlider;
@@ -203,10 +275,10 @@ private:
     std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> harmGritAttach, harmClarityAttach;
 
     RackModule shiftModule;
-    juce::Slider shiftPitchSlider, shiftFormantSlider;
-    juce::Label shiftPitchLabel, shiftFormantLabel;
+    juce::Slider shiftPitchSlider, shiftFormantSlider, shiftVoicesSlider, shiftSpreadSlider;
+    juce::Label shiftPitchLabel, shiftFormantLabel, shiftVoicesLabel, shiftSpreadLabel;
     PatchCable shiftCable;
-    std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> shiftPitchAttach, shiftFormantAttach;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> shiftPitchAttach, shiftFormantAttach, shiftVoicesAttach, shiftSpreadAttach;
 
     RackModule spaceModule;
     juce::Slider spaceMixSlider, spaceCharSlider;
@@ -225,5 +297,17 @@ private:
     juce::Label wallDriveLabel, wallCeilLabel, voidWidthLabel;
     std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> wallDriveAttach, wallCeilAttach, voidWidthAttach;
 
+    juce::ComboBox makeupModeBox;
+    juce::Slider makeupTargetSlider;
+    juce::Label makeupLabel;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::ComboBoxAttachment> makeupModeAttach;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> makeupTargetAttach;
+
+    juce::TextButton storeAButton, storeBButton;
+    juce::ToggleButton abToggle;
+    juce::Slider abMorphSlider;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::ButtonAttachment> abEnabledAttach;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> abMorphAttach;
+
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (VocalAggressorRackEditor)
 };